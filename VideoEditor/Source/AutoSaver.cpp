@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    AutoSaver.cpp
+    Created: 17 Oct 2026 8:38:18pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+#include "AutoSaver.h"
+
+namespace IDs
+{
+    static Identifier originalFile { "originalFile" };
+}
+
+//==============================================================================
+AutoSaver::AutoSaver()
+{
+}
+
+AutoSaver::~AutoSaver()
+{
+    if (edit)
+        edit->getStatusTree().removeListener (this);
+
+    writer.removeAllJobs (false, 5000);
+}
+
+void AutoSaver::setEdit (std::shared_ptr<foleys::ComposedClip> editToWatch, const File& file)
+{
+    if (edit)
+        edit->getStatusTree().removeListener (this);
+
+    edit = editToWatch;
+    editFile = file;
+    changed = false;
+    lastSaveTime = Time::getApproximateMillisecondCounter();
+
+    if (edit)
+        edit->getStatusTree().addListener (this);
+}
+
+void AutoSaver::setIntervalInSeconds (int seconds)
+{
+    intervalInSeconds = jmax (1, seconds);
+}
+
+void AutoSaver::markChanged()
+{
+    changed = true;
+}
+
+void AutoSaver::saveIfNeeded()
+{
+    const auto now = Time::getApproximateMillisecondCounter();
+    if (edit == nullptr || ! changed || writing.load() || now - lastSaveTime < uint32 (intervalInSeconds) * 1000)
+        return;
+
+    edit->readPluginStatesIntoValueTree();
+
+    // the copy doesn't share any objects with the edit, so it is safe to serialise it on the writer thread
+    auto snapshot = edit->getStatusTree().createCopy();
+    snapshot.setProperty (IDs::originalFile, editFile.getFullPathName(), nullptr);
+
+    changed = false;
+    lastSaveTime = now;
+    writing.store (true);
+
+    writer.addJob ([snapshot, &flag = writing]
+    {
+        TemporaryFile temp (getRecoveryFile());
+        if (EditFile::writeTree (snapshot, temp.getFile(), EditFile::Format::compressed))
+            temp.overwriteTargetFileWithTemporary();
+
+        flag.store (false);
+        return ThreadPoolJob::jobHasFinished;
+    });
+}
+
+void AutoSaver::clear()
+{
+    // wait for a running job, otherwise it would write the file again
+    // a job removed before it ran never resets the flag, a running one still does
+    if (writer.removeAllJobs (false, 5000))
+        writing.store (false);
+
+    changed = false;
+    lastSaveTime = Time::getApproximateMillisecondCounter();
+    getRecoveryFile().deleteFile();
+}
+
+File AutoSaver::getRecoveryFile()
+{
+    return EditFile::getSettingsFolder().getChildFile ("Autosave.videdit");
+}
+
+File AutoSaver::getOriginalFile (const File& recoveryFile)
+{
+    const auto path = EditFile::readTree (recoveryFile).getProperty (IDs::originalFile).toString();
+    return File::isAbsolutePath (path) ? File (path) : File();
+}
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    AutoSaver.h
+    Created: 17 Oct 2026 8:38:18pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    Saves a copy of the edit periodically into the settings folder, so it can
+    be recovered after a crash.
+
+    The snapshot is a copy of the status tree taken on the message thread at
+    a transaction boundary. Serialising and writing happens on a background
+    thread into a temporary file, which then replaces the autosave file.
+*/
+class AutoSaver  : private ValueTree::Listener
+{
+public:
+    AutoSaver();
+    ~AutoSaver();
+
+    /** Set the edit to watch. The file is the edit's own file, if it was saved before */
+    void setEdit (std::shared_ptr<foleys::ComposedClip> edit, const File& editFile);
+
+    /** Call this at a transaction boundary. Takes a snapshot, if the edit changed and the interval elapsed */
+    void saveIfNeeded();
+
+    /** Call this after the edit was saved by the user, it removes the autosave file */
+    void clear();
+
+    void setIntervalInSeconds (int seconds);
+
+    /** Returns the autosave file, if there is one left from a previous session */
+    static File getRecoveryFile();
+
+    /** Returns the file the recovered edit was saved to by the user, if any */
+    static File getOriginalFile (const File& recoveryFile);
+
+private:
+
+    void markChanged();
+
+    void valueTreePropertyChanged (ValueTree&, const Identifier&) override          { markChanged(); }
+    void valueTreeChildAdded (ValueTree&, ValueTree&) override                      { markChanged(); }
+    void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override               { markChanged(); }
+    void valueTreeChildOrderChanged (ValueTree&, int, int) override                 { markChanged(); }
+    void valueTreeParentChanged (ValueTree&) override                               {}
+
+    std::shared_ptr<foleys::ComposedClip> edit;
+    File   editFile;
+    bool   changed = false;
+    int    intervalInSeconds = 60;
+    uint32 lastSaveTime = 0;
+
+    std::atomic<bool> writing { false };
+    ThreadPool writer { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutoSaver)
+};
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    AutomationCurve.cpp
+    Created: 17 Oct 2026 9:01:34pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "AutomationCurve.h"
+
+//==============================================================================
+
+AutomationCurve::AutomationCurve (foleys::ParameterAutomation& automationToUse)
+  : automation (automationToUse)
+{
+    update();
+}
+
+void AutomationCurve::update()
+{
+    const auto& keyframes = automation.getKeyframes();
+
+    times.clear();
+    values.clear();
+    times.reserve (keyframes.size());
+    values.reserve (keyframes.size());
+
+    // the keyframes are already ordered by time
+    for (const auto& keyframe : keyframes)
+    {
+        times.push_back (keyframe.first);
+        values.push_back (keyframe.second);
+    }
+
+    lastSegment = -1;
+}
+
+double AutomationCurve::getValueForTime (double time) const
+{
+    if (times.empty())
+        return automation.getValueForTime (time);
+
+    const auto segment = findSegment (time);
+
+    if (segment < 0)
+        return values.front();
+
+    if (segment + 1 >= int (times.size()))
+        return values.back();
+
+    const auto index = size_t (segment);
+    return jmap (time, times [index], times [index + 1], values [index], values [index + 1]);
+}
+
+int AutomationCurve::getFirstKeyframeAt (double time) const
+{
+    return int (std::lower_bound (times.begin(), times.end(), time) - times.begin());
+}
+
+int AutomationCurve::getNumKeyframes() const
+{
+    return int (times.size());
+}
+
+double AutomationCurve::getKeyframeTime (int index) const
+{
+    return times [size_t (index)];
+}
+
+double AutomationCurve::getKeyframeValue (int index) const
+{
+    return values [size_t (index)];
+}
+
+foleys::ParameterAutomation& AutomationCurve::getAutomation() const
+{
+    return automation;
+}
+
+void AutomationCurve::getValuesForTime (const std::vector<const AutomationCurve*>& curves, double time, std::vector<double>& valuesForTime)
+{
+    valuesForTime.resize (curves.size());
+
+    for (size_t i = 0; i < curves.size(); ++i)
+        valuesForTime [i] = curves [i]->getValueForTime (time);
+}
+
+//==============================================================================
+
+int AutomationCurve::findSegment (double time) const
+{
+    const auto numKeyframes = int (times.size());
+
+    auto isInSegment = [&](int segment)
+    {
+        return (segment < 0 || times [size_t (segment)] <= time)
+            && (segment + 1 >= numKeyframes || time < times [size_t (segment + 1)]);
+    };
+
+    // playback moves on by at most one keyframe between two lookups
+    if (lastSegment < numKeyframes)
+    {
+        if (isInSegment (lastSegment))
+            return lastSegment;
+
+        if (lastSegment + 1 < numKeyframes && isInSegment (lastSegment + 1))
+            return ++lastSegment;
+    }
+
+    lastSegment = int (std::upper_bound (times.begin(), times.end(), time) - times.begin()) - 1;
+    return lastSegment;
+}
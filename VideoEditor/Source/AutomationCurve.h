@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    AutomationCurve.h
+    Created: 17 Oct 2026 9:01:34pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    A sorted flat copy of the keyframes of a ParameterAutomation for the views.
+    Lookups are binary searches. A lookup close to the previous one, like
+    during playback, starts at the previously found segment and needs no
+    search at all. Call update() when the automation changed.
+*/
+class AutomationCurve
+{
+public:
+    AutomationCurve (foleys::ParameterAutomation& automation);
+
+    /** Copies the keyframes from the automation again */
+    void update();
+
+    /** Interpolates linearly between the keyframes, like the automation itself */
+    double getValueForTime (double time) const;
+
+    /** Returns the index of the first keyframe at or after time */
+    int getFirstKeyframeAt (double time) const;
+
+    int getNumKeyframes() const;
+    double getKeyframeTime (int index) const;
+    double getKeyframeValue (int index) const;
+
+    foleys::ParameterAutomation& getAutomation() const;
+
+    /** Evaluates all curves at the same time, values is resized to the number of curves */
+    static void getValuesForTime (const std::vector<const AutomationCurve*>& curves, double time, std::vector<double>& values);
+
+private:
+
+    /** Returns the index of the last keyframe at or before time, or -1 */
+    int findSegment (double time) const;
+
+    foleys::ParameterAutomation& automation;
+
+    std::vector<double> times;
+    std::vector<double> values;
+
+    mutable int lastSegment = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomationCurve)
+};
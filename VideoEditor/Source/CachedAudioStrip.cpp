@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    CachedAudioStrip.cpp
+    Created: 17 Oct 2026 8:45:39pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "CachedAudioStrip.h"
+
+//==============================================================================
+CachedAudioStrip::CachedAudioStrip (PeakCache& cacheToUse)
+  : cache (cacheToUse)
+{
+    cache.addChangeListener (this);
+}
+
+CachedAudioStrip::~CachedAudioStrip()
+{
+    cache.removeChangeListener (this);
+}
+
+void CachedAudioStrip::setClip (std::shared_ptr<foleys::AVClip> clipToUse)
+{
+    clip = clipToUse;
+    media = clip != nullptr ? clip->getMediaFile() : URL();
+    peaks.reset();
+    fallback.reset();
+
+    if (clip != nullptr)
+    {
+        if (cache.canBuild (media))
+        {
+            peaks = cache.getPeakFile (media);
+        }
+        else
+        {
+            fallback = std::make_unique<foleys::AudioStrip>();
+            fallback->setClip (clip);
+            fallback->setStartAndEnd (startTime, endTime);
+            addAndMakeVisible (fallback.get());
+            resized();
+        }
+    }
+
+    repaint();
+}
+
+void CachedAudioStrip::setStartAndEnd (double start, double end)
+{
+    startTime = start;
+    endTime = end;
+
+    if (fallback)
+        fallback->setStartAndEnd (start, end);
+
+    repaint();
+}
+
+void CachedAudioStrip::resized()
+{
+    if (fallback)
+        fallback->setBounds (getLocalBounds());
+}
+
+void CachedAudioStrip::paint (Graphics& g)
+{
+    if (peaks == nullptr || getWidth() <= 0)
+        return;
+
+    const auto clipBounds = g.getClipBounds();
+    const auto pixelStart = jmax (0, clipBounds.getX());
+    const auto pixelEnd   = jmin (getWidth(), clipBounds.getRight());
+    if (pixelEnd <= pixelStart)
+        return;
+
+    // only the pixels that need painting are looked up
+    const auto secondsPerPixel = (endTime - startTime) / getWidth();
+    pixels.resize (size_t (pixelEnd - pixelStart));
+
+    const auto numChannels   = peaks->getNumChannels();
+    const auto channelHeight = getHeight() / float (numChannels);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        peaks->getPeaks (channel, startTime + pixelStart * secondsPerPixel, startTime + pixelEnd * secondsPerPixel, pixels);
+
+        const auto centre = channelHeight * (channel + 0.5f);
+        const auto scale  = channelHeight * 0.5f;
+
+        g.setColour (Colours::lightgreen.withAlpha (0.8f));
+        for (size_t i = 0; i < pixels.size(); ++i)
+            g.drawVerticalLine (pixelStart + int (i), centre - pixels [i].max * scale, centre - pixels [i].min * scale + 1.0f);
+
+        g.setColour (Colours::white.withAlpha (0.4f));
+        for (size_t i = 0; i < pixels.size(); ++i)
+            g.drawVerticalLine (pixelStart + int (i), centre - pixels [i].rms * scale, centre + pixels [i].rms * scale + 1.0f);
+    }
+}
+
+void CachedAudioStrip::changeListenerCallback (ChangeBroadcaster*)
+{
+    // a build finished, maybe the one for this clip
+    if (peaks != nullptr || clip == nullptr || fallback != nullptr)
+        return;
+
+    if (! cache.canBuild (media))
+    {
+        setClip (clip);
+        return;
+    }
+
+    peaks = cache.getPeakFile (media);
+    if (peaks != nullptr)
+        repaint();
+}
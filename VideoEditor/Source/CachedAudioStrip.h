@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    CachedAudioStrip.h
+    Created: 17 Oct 2026 8:45:39pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "PeakCache.h"
+
+//==============================================================================
+/*
+    Draws the waveform of an audio clip from the PeakFile of its media. Media
+    that can't be read by the AudioFormatManager is drawn by a
+    foleys::AudioStrip instead.
+*/
+class CachedAudioStrip  : public Component,
+                          private ChangeListener
+{
+public:
+    CachedAudioStrip (PeakCache& cache);
+    ~CachedAudioStrip();
+
+    /** Sets the clip to show, nullptr releases it */
+    void setClip (std::shared_ptr<foleys::AVClip> clip);
+
+    /** Sets the time range of the clip in seconds */
+    void setStartAndEnd (double start, double end);
+
+    void paint (Graphics& g) override;
+    void resized() override;
+
+private:
+
+    void changeListenerCallback (ChangeBroadcaster*) override;
+
+    PeakCache& cache;
+
+    std::shared_ptr<foleys::AVClip> clip;
+    URL media;
+    std::shared_ptr<PeakFile> peaks;
+    std::unique_ptr<foleys::AudioStrip> fallback;
+
+    double startTime = 0.0;
+    double endTime   = 0.0;
+
+    std::vector<PeakFile::Peak> pixels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedAudioStrip)
+};
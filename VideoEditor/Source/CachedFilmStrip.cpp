@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    CachedFilmStrip.cpp
+    Created: 17 Oct 2026 8:43:53pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ThumbnailCache.h"
+#include "CachedFilmStrip.h"
+
+//==============================================================================
+CachedFilmStrip::CachedFilmStrip (ThumbnailCache& cacheToUse)
+  : cache (cacheToUse)
+{
+    setOpaque (false);
+
+    state->owner = this;
+}
+
+CachedFilmStrip::~CachedFilmStrip()
+{
+    // a running job stops at its next tile and doesn't notify anymore
+    ++state->tilesVersion;
+
+    const ScopedLock sl (state->lock);
+    state->owner = nullptr;
+}
+
+void CachedFilmStrip::setClip (std::shared_ptr<foleys::AVClip> clipToUse)
+{
+    clip = clipToUse;
+    mediaId = clip != nullptr ? ThumbnailCache::getMediaId (*clip) : String();
+
+    updateTiles();
+}
+
+void CachedFilmStrip::setStartAndEnd (double start, double end)
+{
+    if (start == startTime && end == endTime)
+        return;
+
+    startTime = start;
+    endTime = end;
+    updateTiles();
+}
+
+void CachedFilmStrip::resized()
+{
+    updateTiles();
+}
+
+int CachedFilmStrip::getTileWidth() const
+{
+    return jmax (1, roundToInt (getHeight() * tileAspectRatio));
+}
+
+void CachedFilmStrip::updateTiles()
+{
+    // the job of the previous tiles stops after the thumbnail it's decoding
+    const auto version = ++state->tilesVersion;
+
+    std::vector<int64> newTiles;
+
+    if (clip != nullptr && getWidth() > 0 && getHeight() > 0 && endTime > startTime)
+    {
+        const auto tileWidth = getTileWidth();
+        const auto secondsPerTile = (endTime - startTime) * tileWidth / getWidth();
+        const auto grid = std::exp2 (std::floor (std::log2 (secondsPerTile)));
+
+        for (int x = 0; x < getWidth(); x += tileWidth)
+        {
+            const auto seconds = startTime + (endTime - startTime) * x / getWidth();
+            newTiles.push_back (int64 (std::round (seconds / grid) * grid * 1000.0));
+        }
+    }
+
+    tiles.swap (newTiles);
+    repaint();
+
+    if (! tiles.empty())
+        cache.getThreadPool().addJob (new ThumbnailJob (cache, state, clip, mediaId, tiles, getHeight(), version), true);
+}
+
+void CachedFilmStrip::paint (Graphics& g)
+{
+    const auto tileWidth = getTileWidth();
+    auto x = 0;
+
+    // only the thumbnails in memory, the job reads the others from disk and repaints when they arrive
+    for (auto millis : tiles)
+    {
+        auto image = cache.getMemoryThumbnail (mediaId, millis, getHeight());
+        if (image.isValid())
+            g.drawImageWithin (image, x, 0, tileWidth, getHeight(), RectanglePlacement::centred);
+
+        x += tileWidth;
+    }
+}
+
+void CachedFilmStrip::handleAsyncUpdate()
+{
+    // the first thumbnail tells the real aspect ratio
+    if (tileAspectRatio != state->aspectRatio.load())
+    {
+        tileAspectRatio = state->aspectRatio.load();
+        updateTiles();
+        return;
+    }
+
+    repaint();
+}
+
+//==============================================================================
+
+CachedFilmStrip::ThumbnailJob::ThumbnailJob (ThumbnailCache& cacheToUse, std::shared_ptr<SharedState> stateToUse,
+                                             std::shared_ptr<foleys::AVClip> clipToUse, const String& mediaIdToUse,
+                                             std::vector<int64> tilesToUse, int heightToUse, int versionToUse)
+  : ThreadPoolJob ("Thumbnails"),
+    cache (cacheToUse),
+    state (stateToUse),
+    clip (clipToUse),
+    mediaId (mediaIdToUse),
+    tiles (std::move (tilesToUse)),
+    height (heightToUse),
+    version (versionToUse)
+{
+}
+
+ThreadPoolJob::JobStatus CachedFilmStrip::ThumbnailJob::runJob()
+{
+    for (auto millis : tiles)
+    {
+        if (shouldExit() || clip == nullptr || state->tilesVersion.load() != version)
+            return jobHasFinished;
+
+        auto image = cache.getThumbnail (*clip, mediaId, millis, height);
+        if (image.isValid())
+        {
+            state->aspectRatio.store (image.getWidth() / float (image.getHeight()));
+
+            const ScopedLock sl (state->lock);
+            if (state->owner != nullptr)
+                state->owner->triggerAsyncUpdate();
+        }
+    }
+
+    return jobHasFinished;
+}
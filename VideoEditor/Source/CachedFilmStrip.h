@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    CachedFilmStrip.h
+    Created: 17 Oct 2026 8:43:53pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class ThumbnailCache;
+
+//==============================================================================
+/*
+    Shows thumbnails of a video clip, like foleys::FilmStrip, but takes them
+    from the shared ThumbnailCache.
+
+    The thumbnails are placed on a time grid with a power of two spacing in
+    seconds, so the same thumbnails are reused at different zoom levels and
+    by the parts of a split clip.
+*/
+class CachedFilmStrip  : public Component,
+                         private AsyncUpdater
+{
+public:
+    CachedFilmStrip (ThumbnailCache& cache);
+    ~CachedFilmStrip();
+
+    /** Sets the clip to show, nullptr cancels the decoding */
+    void setClip (std::shared_ptr<foleys::AVClip> clip);
+
+    /** Sets the time range of the clip in seconds */
+    void setStartAndEnd (double start, double end);
+
+    void paint (Graphics& g) override;
+    void resized() override;
+
+private:
+
+    /*
+        Shared by the strip and its jobs. A job that is still decoding when the
+        strip changed or was deleted sees the new version and stops, without
+        the strip having to wait for it.
+    */
+    struct SharedState
+    {
+        std::atomic<int>   tilesVersion { 0 };
+        std::atomic<float> aspectRatio  { 16.0f / 9.0f };
+
+        CriticalSection  lock;
+        CachedFilmStrip* owner = nullptr;
+    };
+
+    /** Decodes the tiles of one version, it has its own copy of everything it reads */
+    class ThumbnailJob  : public ThreadPoolJob
+    {
+    public:
+        ThumbnailJob (ThumbnailCache& cache, std::shared_ptr<SharedState> state,
+                      std::shared_ptr<foleys::AVClip> clip, const String& mediaId,
+                      std::vector<int64> tiles, int height, int version);
+
+        JobStatus runJob() override;
+
+    private:
+        ThumbnailCache& cache;
+        std::shared_ptr<SharedState> state;
+        std::shared_ptr<foleys::AVClip> clip;
+        const String mediaId;
+        const std::vector<int64> tiles;
+        const int height;
+        const int version;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThumbnailJob)
+    };
+
+    void handleAsyncUpdate() override;
+    void updateTiles();
+
+    int getTileWidth() const;
+
+    ThumbnailCache& cache;
+    std::shared_ptr<SharedState> state { std::make_shared<SharedState>() };
+
+    std::shared_ptr<foleys::AVClip> clip;
+    String mediaId;
+    double startTime = 0.0;
+    double endTime   = 0.0;
+
+    std::vector<int64> tiles;
+    float tileAspectRatio = 16.0f / 9.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedFilmStrip)
+};
@@ -0,0 +1,521 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    Compositor.cpp
+    Created: 17 Oct 2026 8:53:09pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Compositor.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+ #if JUCE_MSVC
+  #define COMPOSITOR_TARGET(isa)
+ #else
+  #define COMPOSITOR_TARGET(isa) __attribute__ ((target (isa)))
+ #endif
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define COMPOSITOR_NEON 1
+#endif
+
+namespace
+{
+    /*
+        All kernels work on rows of premultiplied pixels. The opacity is given
+        as 0..255, products are divided by 255 with rounding.
+    */
+    struct Kernels
+    {
+        void (*blend) (uint8* dest, const uint8* source, int numPixels, int opacity);
+        void (*opacity) (uint8* data, int numBytes, int opacity);
+        void (*convert) (uint8* dest, const uint8* source, int numPixels);
+    };
+
+    inline int mul255 (int a, int b)
+    {
+        const auto t = a * b + 128;
+        return (t + (t >> 8)) >> 8;
+    }
+
+    //==============================================================================
+
+    void blendScalar (uint8* dest, const uint8* source, int numPixels, int opacity)
+    {
+        for (int i = 0; i < numPixels; ++i, dest += 4, source += 4)
+        {
+            const auto inverse = 255 - mul255 (source [PixelARGB::indexA], opacity);
+
+            for (int c = 0; c < 4; ++c)
+                dest [c] = uint8 (jmin (255, mul255 (source [c], opacity) + mul255 (dest [c], inverse)));
+        }
+    }
+
+    void opacityScalar (uint8* data, int numBytes, int opacity)
+    {
+        for (int i = 0; i < numBytes; ++i)
+            data [i] = uint8 (mul255 (data [i], opacity));
+    }
+
+    void convertScalar (uint8* dest, const uint8* source, int numPixels)
+    {
+        for (int i = 0; i < numPixels; ++i, dest += 4, source += 3)
+        {
+            dest [PixelARGB::indexR] = source [PixelRGB::indexR];
+            dest [PixelARGB::indexG] = source [PixelRGB::indexG];
+            dest [PixelARGB::indexB] = source [PixelRGB::indexB];
+            dest [PixelARGB::indexA] = 255;
+        }
+    }
+
+    //==============================================================================
+
+#if JUCE_INTEL
+
+    // The SIMD kernels expect the little endian layout B, G, R, A
+
+    COMPOSITOR_TARGET ("sse4.1")
+    inline __m128i mul255 (__m128i a, __m128i b)
+    {
+        const auto t = _mm_add_epi16 (_mm_mullo_epi16 (a, b), _mm_set1_epi16 (128));
+        return _mm_srli_epi16 (_mm_add_epi16 (t, _mm_srli_epi16 (t, 8)), 8);
+    }
+
+    COMPOSITOR_TARGET ("sse4.1")
+    inline __m128i blendPixels (__m128i source, __m128i dest, __m128i opacity)
+    {
+        const auto alphaMask = _MM_SHUFFLE (3, 3, 3, 3);
+        const auto zero = _mm_setzero_si128();
+        const auto full = _mm_set1_epi16 (255);
+
+        const auto sourceLo = mul255 (_mm_unpacklo_epi8 (source, zero), opacity);
+        const auto sourceHi = mul255 (_mm_unpackhi_epi8 (source, zero), opacity);
+        const auto alphaLo  = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (sourceLo, alphaMask), alphaMask);
+        const auto alphaHi  = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (sourceHi, alphaMask), alphaMask);
+
+        const auto destLo = _mm_add_epi16 (sourceLo, mul255 (_mm_unpacklo_epi8 (dest, zero), _mm_sub_epi16 (full, alphaLo)));
+        const auto destHi = _mm_add_epi16 (sourceHi, mul255 (_mm_unpackhi_epi8 (dest, zero), _mm_sub_epi16 (full, alphaHi)));
+
+        return _mm_packus_epi16 (destLo, destHi);
+    }
+
+    COMPOSITOR_TARGET ("sse4.1")
+    void blendSSE41 (uint8* dest, const uint8* source, int numPixels, int opacity)
+    {
+        const auto factor = _mm_set1_epi16 (short (opacity));
+
+        int i = 0;
+        for (; i + 4 <= numPixels; i += 4)
+        {
+            auto* d = reinterpret_cast<__m128i*> (dest + 4 * i);
+            _mm_storeu_si128 (d, blendPixels (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + 4 * i)),
+                                              _mm_loadu_si128 (d), factor));
+        }
+
+        blendScalar (dest + 4 * i, source + 4 * i, numPixels - i, opacity);
+    }
+
+    COMPOSITOR_TARGET ("sse4.1")
+    void opacitySSE41 (uint8* data, int numBytes, int opacity)
+    {
+        const auto factor = _mm_set1_epi16 (short (opacity));
+        const auto zero = _mm_setzero_si128();
+
+        int i = 0;
+        for (; i + 16 <= numBytes; i += 16)
+        {
+            auto* d = reinterpret_cast<__m128i*> (data + i);
+            const auto value = _mm_loadu_si128 (d);
+            _mm_storeu_si128 (d, _mm_packus_epi16 (mul255 (_mm_unpacklo_epi8 (value, zero), factor),
+                                                   mul255 (_mm_unpackhi_epi8 (value, zero), factor)));
+        }
+
+        opacityScalar (data + i, numBytes - i, opacity);
+    }
+
+    COMPOSITOR_TARGET ("sse4.1")
+    void convertSSE41 (uint8* dest, const uint8* source, int numPixels)
+    {
+        // the byte order of PixelRGB differs between the platforms (B,G,R, but R,G,B on the Mac)
+        alignas (16) int8 order [16];
+        for (int pixel = 0; pixel < 4; ++pixel)
+        {
+            order [4 * pixel + PixelARGB::indexR] = int8 (3 * pixel + PixelRGB::indexR);
+            order [4 * pixel + PixelARGB::indexG] = int8 (3 * pixel + PixelRGB::indexG);
+            order [4 * pixel + PixelARGB::indexB] = int8 (3 * pixel + PixelRGB::indexB);
+            order [4 * pixel + PixelARGB::indexA] = -1;
+        }
+
+        const auto shuffle = _mm_load_si128 (reinterpret_cast<const __m128i*> (order));
+        const auto alpha   = _mm_set1_epi32 (int (0xff000000));
+
+        // 16 bytes are loaded for 4 pixels, so the last ones are left to the scalar loop
+        int i = 0;
+        for (; i + 6 <= numPixels; i += 4)
+        {
+            const auto value = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + 3 * i));
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + 4 * i), _mm_or_si128 (_mm_shuffle_epi8 (value, shuffle), alpha));
+        }
+
+        convertScalar (dest + 4 * i, source + 3 * i, numPixels - i);
+    }
+
+    //==============================================================================
+
+    COMPOSITOR_TARGET ("avx2")
+    inline __m256i mul255 (__m256i a, __m256i b)
+    {
+        const auto t = _mm256_add_epi16 (_mm256_mullo_epi16 (a, b), _mm256_set1_epi16 (128));
+        return _mm256_srli_epi16 (_mm256_add_epi16 (t, _mm256_srli_epi16 (t, 8)), 8);
+    }
+
+    COMPOSITOR_TARGET ("avx2")
+    void blendAVX2 (uint8* dest, const uint8* source, int numPixels, int opacity)
+    {
+        // unpack, shuffle and pack work within 128 bit lanes, so the pixels stay in order
+        const auto alphaMask = _MM_SHUFFLE (3, 3, 3, 3);
+        const auto factor = _mm256_set1_epi16 (short (opacity));
+        const auto zero = _mm256_setzero_si256();
+        const auto full = _mm256_set1_epi16 (255);
+
+        int i = 0;
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            auto* d = reinterpret_cast<__m256i*> (dest + 4 * i);
+            const auto s = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (source + 4 * i));
+            const auto value = _mm256_loadu_si256 (d);
+
+            const auto sourceLo = mul255 (_mm256_unpacklo_epi8 (s, zero), factor);
+            const auto sourceHi = mul255 (_mm256_unpackhi_epi8 (s, zero), factor);
+            const auto alphaLo  = _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (sourceLo, alphaMask), alphaMask);
+            const auto alphaHi  = _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (sourceHi, alphaMask), alphaMask);
+
+            const auto destLo = _mm256_add_epi16 (sourceLo, mul255 (_mm256_unpacklo_epi8 (value, zero), _mm256_sub_epi16 (full, alphaLo)));
+            const auto destHi = _mm256_add_epi16 (sourceHi, mul255 (_mm256_unpackhi_epi8 (value, zero), _mm256_sub_epi16 (full, alphaHi)));
+
+            _mm256_storeu_si256 (d, _mm256_packus_epi16 (destLo, destHi));
+        }
+
+        blendSSE41 (dest + 4 * i, source + 4 * i, numPixels - i, opacity);
+    }
+
+    COMPOSITOR_TARGET ("avx2")
+    void opacityAVX2 (uint8* data, int numBytes, int opacity)
+    {
+        const auto factor = _mm256_set1_epi16 (short (opacity));
+        const auto zero = _mm256_setzero_si256();
+
+        int i = 0;
+        for (; i + 32 <= numBytes; i += 32)
+        {
+            auto* d = reinterpret_cast<__m256i*> (data + i);
+            const auto value = _mm256_loadu_si256 (d);
+            _mm256_storeu_si256 (d, _mm256_packus_epi16 (mul255 (_mm256_unpacklo_epi8 (value, zero), factor),
+                                                         mul255 (_mm256_unpackhi_epi8 (value, zero), factor)));
+        }
+
+        opacitySSE41 (data + i, numBytes - i, opacity);
+    }
+
+#elif COMPOSITOR_NEON
+
+    inline uint8x8_t mul255 (uint8x8_t a, uint8x8_t b)
+    {
+        const auto t = vmull_u8 (a, b);
+        return vrshrn_n_u16 (vrsraq_n_u16 (t, t, 8), 8);
+    }
+
+    void blendNEON (uint8* dest, const uint8* source, int numPixels, int opacity)
+    {
+        const auto factor = vdup_n_u8 (uint8 (opacity));
+
+        int i = 0;
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            const auto s = vld4_u8 (source + 4 * i);
+            auto d = vld4_u8 (dest + 4 * i);
+
+            const auto inverse = vmvn_u8 (mul255 (s.val [3], factor));
+
+            for (int c = 0; c < 4; ++c)
+                d.val [c] = vqadd_u8 (mul255 (s.val [c], factor), mul255 (d.val [c], inverse));
+
+            vst4_u8 (dest + 4 * i, d);
+        }
+
+        blendScalar (dest + 4 * i, source + 4 * i, numPixels - i, opacity);
+    }
+
+    void opacityNEON (uint8* data, int numBytes, int opacity)
+    {
+        const auto factor = vdup_n_u8 (uint8 (opacity));
+
+        int i = 0;
+        for (; i + 8 <= numBytes; i += 8)
+            vst1_u8 (data + i, mul255 (vld1_u8 (data + i), factor));
+
+        opacityScalar (data + i, numBytes - i, opacity);
+    }
+
+    void convertNEON (uint8* dest, const uint8* source, int numPixels)
+    {
+        int i = 0;
+        for (; i + 8 <= numPixels; i += 8)
+        {
+            const auto rgb = vld3_u8 (source + 3 * i);
+
+            // the byte order of PixelRGB differs between the platforms (B,G,R, but R,G,B on the Mac)
+            uint8x8x4_t argb;
+            argb.val [PixelARGB::indexR] = rgb.val [PixelRGB::indexR];
+            argb.val [PixelARGB::indexG] = rgb.val [PixelRGB::indexG];
+            argb.val [PixelARGB::indexB] = rgb.val [PixelRGB::indexB];
+            argb.val [PixelARGB::indexA] = vdup_n_u8 (255);
+
+            vst4_u8 (dest + 4 * i, argb);
+        }
+
+        convertScalar (dest + 4 * i, source + 3 * i, numPixels - i);
+    }
+
+#endif
+
+    Kernels getKernels (Compositor::Kernel kernel)
+    {
+        switch (kernel)
+        {
+           #if JUCE_INTEL
+            case Compositor::Kernel::avx2:  return { blendAVX2, opacityAVX2, convertSSE41 };
+            case Compositor::Kernel::sse41: return { blendSSE41, opacitySSE41, convertSSE41 };
+           #elif COMPOSITOR_NEON
+            case Compositor::Kernel::neon:  return { blendNEON, opacityNEON, convertNEON };
+           #endif
+            default:                        return { blendScalar, opacityScalar, convertScalar };
+        }
+    }
+
+    /** The kernels convert packed RGB, other layouts are converted by juce */
+    bool isPackedRGB (const Image& image)
+    {
+        if (image.getFormat() != Image::RGB)
+            return false;
+
+        const Image::BitmapData data (image, Image::BitmapData::readOnly);
+        return data.pixelStride == 3;
+    }
+
+    Image createARGB (const Image& source, FramePool* pool)
+    {
+        return pool != nullptr ? pool->acquire (Image::ARGB, source.getWidth(), source.getHeight())
+                               : Image (Image::ARGB, source.getWidth(), source.getHeight(), false);
+    }
+}
+
+//==============================================================================
+
+Compositor::Compositor (int numThreads)
+  : numTiles (jmax (1, numThreads)),
+    threadPool (jmax (1, numThreads - 1))
+{
+}
+
+Compositor::~Compositor()
+{
+    threadPool.removeAllJobs (true, 1000);
+}
+
+Compositor::Kernel Compositor::getBestKernel()
+{
+    for (auto candidate : { Kernel::avx2, Kernel::sse41, Kernel::neon })
+        if (isSupported (candidate))
+            return candidate;
+
+    return Kernel::scalar;
+}
+
+String Compositor::getKernelName (Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::sse41: return "SSE4.1";
+        case Kernel::avx2:  return "AVX2";
+        case Kernel::neon:  return "NEON";
+        case Kernel::scalar:
+        default:            return "scalar";
+    }
+}
+
+bool Compositor::isSupported (Kernel kernelToCheck)
+{
+    switch (kernelToCheck)
+    {
+       #if JUCE_INTEL
+        case Kernel::sse41: return SystemStats::hasSSE41();
+        case Kernel::avx2:  return SystemStats::hasAVX2() && SystemStats::hasSSE41();
+       #elif COMPOSITOR_NEON
+        case Kernel::neon:  return true;
+       #endif
+        case Kernel::scalar:    return true;
+        default:                return false;
+    }
+}
+
+void Compositor::setKernel (Kernel kernelToUse)
+{
+    kernel = isSupported (kernelToUse) ? kernelToUse : Kernel::scalar;
+}
+
+Compositor::Kernel Compositor::getKernel() const
+{
+    return kernel;
+}
+
+void Compositor::setNumTiles (int numTilesToUse)
+{
+    numTiles = jmax (1, numTilesToUse);
+}
+
+void Compositor::blend (Image& dest, const Image& source, float opacity)
+{
+    jassert (dest.getFormat() == Image::ARGB);
+
+    if (source.getFormat() != Image::ARGB)
+    {
+        blend (dest, convertToARGB (source), opacity);
+        return;
+    }
+
+    const auto alpha  = roundToInt (jlimit (0.0f, 1.0f, opacity) * 255.0f);
+    const auto width  = jmin (dest.getWidth(), source.getWidth());
+    const auto height = jmin (dest.getHeight(), source.getHeight());
+
+    if (alpha == 0 || width <= 0 || height <= 0)
+        return;
+
+    Image::BitmapData destData (dest, 0, 0, width, height, Image::BitmapData::readWrite);
+    const Image::BitmapData sourceData (source, 0, 0, width, height, Image::BitmapData::readOnly);
+    const auto kernels = getKernels (kernel);
+
+    forEachTile (height, [&](int startRow, int endRow)
+    {
+        for (int y = startRow; y < endRow; ++y)
+            kernels.blend (destData.getLinePointer (y), sourceData.getLinePointer (y), width, alpha);
+    });
+}
+
+void Compositor::applyOpacity (Image& image, float opacity)
+{
+    jassert (image.getFormat() == Image::ARGB);
+
+    const auto alpha = roundToInt (jlimit (0.0f, 1.0f, opacity) * 255.0f);
+    if (alpha == 255 || ! image.isValid())
+        return;
+
+    Image::BitmapData data (image, Image::BitmapData::readWrite);
+    const auto kernels = getKernels (kernel);
+
+    forEachTile (data.height, [&](int startRow, int endRow)
+    {
+        for (int y = startRow; y < endRow; ++y)
+            kernels.opacity (data.getLinePointer (y), data.width * data.pixelStride, alpha);
+    });
+}
+
+Image Compositor::convertToARGB (const Image& source)
+{
+    if (source.getFormat() == Image::ARGB)
+        return source.createCopy();
+
+    if (! isPackedRGB (source))
+        return source.convertedToFormat (Image::ARGB);
+
+    const Image::BitmapData sourceData (source, Image::BitmapData::readOnly);
+    auto result = createARGB (source, framePool);
+    Image::BitmapData destData (result, Image::BitmapData::writeOnly);
+    const auto kernels = getKernels (kernel);
+
+    forEachTile (sourceData.height, [&](int startRow, int endRow)
+    {
+        for (int y = startRow; y < endRow; ++y)
+            kernels.convert (destData.getLinePointer (y), sourceData.getLinePointer (y), sourceData.width);
+    });
+
+    return result;
+}
+
+Image Compositor::convertToARGB (const Image& source, FramePool* pool)
+{
+    if (source.getFormat() == Image::ARGB)
+        return source.createCopy();
+
+    if (! isPackedRGB (source))
+        return source.convertedToFormat (Image::ARGB);
+
+    static const auto kernels = getKernels (getBestKernel());
+
+    const Image::BitmapData sourceData (source, Image::BitmapData::readOnly);
+    auto result = createARGB (source, pool);
+    Image::BitmapData destData (result, Image::BitmapData::writeOnly);
+
+    for (int y = 0; y < sourceData.height; ++y)
+        kernels.convert (destData.getLinePointer (y), sourceData.getLinePointer (y), sourceData.width);
+
+    return result;
+}
+
+void Compositor::setFramePool (FramePool* pool)
+{
+    framePool = pool;
+}
+
+//==============================================================================
+
+void Compositor::forEachTile (int numRows, std::function<void(int startRow, int endRow)> function)
+{
+    // tiles of less than 16 rows are not worth a thread
+    const auto tiles = jlimit (1, jmax (1, numRows / 16), numTiles);
+
+    if (tiles == 1)
+    {
+        function (0, numRows);
+        return;
+    }
+
+    std::atomic<int> remaining { tiles - 1 };
+    WaitableEvent finished;
+
+    for (int tile = 1; tile < tiles; ++tile)
+    {
+        threadPool.addJob ([&, tile]
+        {
+            function (numRows * tile / tiles, numRows * (tile + 1) / tiles);
+
+            if (--remaining == 0)
+                finished.signal();
+
+            return ThreadPoolJob::jobHasFinished;
+        });
+    }
+
+    function (0, numRows / tiles);
+    finished.wait();
+}
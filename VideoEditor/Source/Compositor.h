@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    Compositor.h
+    Created: 17 Oct 2026 8:52:08pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "FramePool.h"
+
+//==============================================================================
+/*
+    Blends video frames in premultiplied ARGB, the format of juce::Image.
+    The kernels for AVX2, SSE4.1 and NEON are picked at runtime depending on
+    the CPU, with a scalar fallback. Each frame is split into tiles of rows,
+    which are processed in parallel.
+
+    The FramePrefetcher converts the RGB frames for the preview with the
+    static convertToARGB, which needs no Compositor. The blending is only used
+    by the --benchmark-compositing option so far, the preview and the renderer
+    composite with the engine.
+*/
+class Compositor
+{
+public:
+    enum class Kernel
+    {
+        scalar = 0,
+        sse41,
+        avx2,
+        neon
+    };
+
+    Compositor (int numThreads = SystemStats::getNumCpus());
+    ~Compositor();
+
+    /** Draws source over dest at the top left corner, with the source multiplied by opacity */
+    void blend (Image& dest, const Image& source, float opacity);
+
+    /** Multiplies all channels of the premultiplied image with opacity */
+    void applyOpacity (Image& image, float opacity);
+
+    /** Returns an opaque ARGB copy of an RGB image */
+    Image convertToARGB (const Image& source);
+
+    /** Converts on the calling thread with the best kernel, the image is taken from the pool if there is one */
+    static Image convertToARGB (const Image& source, FramePool* pool);
+
+    /** Set a pool to take the converted images from, nullptr allocates a new image each time */
+    void setFramePool (FramePool* pool);
+
+    /** Forces a kernel, e.g. for comparisons. Kernels the CPU doesn't support fall back to scalar. */
+    void setKernel (Kernel kernel);
+    Kernel getKernel() const;
+
+    /** Set the number of tiles a frame is split into, 1 processes the frame on the calling thread */
+    void setNumTiles (int numTiles);
+
+    static bool isSupported (Kernel kernel);
+    static Kernel getBestKernel();
+    static String getKernelName (Kernel kernel);
+
+private:
+
+    /** Runs the function on row ranges, in parallel if more than one tile is used */
+    void forEachTile (int numRows, std::function<void(int startRow, int endRow)> function);
+
+    Kernel kernel = getBestKernel();
+    int    numTiles;
+
+    FramePool* framePool = nullptr;
+
+    ThreadPool threadPool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Compositor)
+};
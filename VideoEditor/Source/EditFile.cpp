@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    EditFile.cpp
+    Created: 17 Oct 2026 8:31:35pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+
+namespace EditFile
+{
+
+// "VEDT" when read as little endian int
+static constexpr int magicNumber   = 0x54444556;
+static constexpr int formatVersion = 1;
+
+File getSettingsFolder()
+{
+    auto settingsFolder = File::getSpecialLocation (File::userApplicationDataDirectory).getChildFile (ProjectInfo::companyName).getChildFile (ProjectInfo::projectName);
+    settingsFolder.createDirectory();
+    return settingsFolder;
+}
+
+ValueTree readTree (const File& file)
+{
+    FileInputStream input (file);
+    if (! input.openedOk())
+        return {};
+
+    if (input.readInt() != magicNumber)
+    {
+        if (auto xml = XmlDocument::parse (file))
+            return ValueTree::fromXml (*xml);
+
+        return {};
+    }
+
+    if (input.readInt() > formatVersion)
+    {
+        DBG ("The file was written by a newer version: " + file.getFullPathName());
+        return {};
+    }
+
+    if (input.readByte() == char (Format::compressed))
+    {
+        GZIPDecompressorInputStream decompressor (input);
+        return ValueTree::readFromStream (decompressor);
+    }
+
+    return ValueTree::readFromStream (input);
+}
+
+bool writeTree (const ValueTree& tree, const File& file, Format format)
+{
+    FileOutputStream output (file);
+    if (! output.openedOk())
+        return false;
+
+    output.setPosition (0);
+    output.truncate();
+
+    if (format == Format::xml)
+        return output.writeString (tree.toXmlString());
+
+    output.writeInt (magicNumber);
+    output.writeInt (formatVersion);
+    output.writeByte (char (format));
+
+    if (format == Format::compressed)
+    {
+        GZIPCompressorOutputStream compressor (output);
+        tree.writeToStream (compressor);
+        compressor.flush();
+    }
+    else
+    {
+        tree.writeToStream (output);
+    }
+
+    output.flush();
+    return output.getStatus().wasOk();
+}
+
+std::shared_ptr<foleys::ComposedClip> load (foleys::VideoEngine& videoEngine, const File& file)
+{
+    auto tree = readTree (file);
+    if (! tree.isValid())
+        return {};
+
+    return createEdit (videoEngine, tree);
+}
+
+std::shared_ptr<foleys::ComposedClip> createEdit (foleys::VideoEngine& videoEngine, ValueTree tree)
+{
+    auto edit = std::make_shared<foleys::ComposedClip>(videoEngine);
+    videoEngine.manageLifeTime (edit);
+
+    // the tree isn't shared, so the clips can be moved over instead of copied
+    auto status = edit->getStatusTree();
+    while (tree.getNumChildren() > 0)
+    {
+        auto clip = tree.getChild (0);
+        tree.removeChild (0, nullptr);
+        status.appendChild (clip, nullptr);
+    }
+
+    return edit;
+}
+
+bool save (foleys::ComposedClip& edit, const File& file, Format format)
+{
+    edit.readPluginStatesIntoValueTree();
+    return writeTree (edit.getStatusTree(), file, format);
+}
+
+} // namespace EditFile
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    EditFile.h
+    Created: 17 Oct 2026 8:31:35pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    Reading and writing of the .videdit project files, shared by the editor
+    and the headless render mode.
+
+    The files start with a magic number and a version, followed by the status
+    tree in ValueTree's binary format, optionally gzip compressed. Files
+    without the magic number are read as XML, as written by older versions.
+*/
+namespace EditFile
+{
+    enum class Format
+    {
+        xml,
+        binary,
+        compressed
+    };
+
+    /** Returns the folder for the application settings, e.g. the PluginList.xml */
+    File getSettingsFolder();
+
+    /** Creates a new edit from the file. Returns nullptr if the file could not be read. */
+    std::shared_ptr<foleys::ComposedClip> load (foleys::VideoEngine& videoEngine, const File& file);
+
+    /** Creates a new edit from a status tree. The clips are moved out of the tree, so it must not be shared. */
+    std::shared_ptr<foleys::ComposedClip> createEdit (foleys::VideoEngine& videoEngine, ValueTree tree);
+
+    /** Writes the edit including the plugin states into the file. Returns false if writing failed. */
+    bool save (foleys::ComposedClip& edit, const File& file, Format format = Format::compressed);
+
+    /** Reads the status tree from the file, in any of the formats */
+    ValueTree readTree (const File& file);
+
+    /** Writes the tree into the file in the given format */
+    bool writeTree (const ValueTree& tree, const File& file, Format format);
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    FramePool.cpp
+    Created: 17 Oct 2026 8:54:18pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "FramePool.h"
+
+//==============================================================================
+
+FramePool::FramePool (int maxFramesPerSize)
+  : maxFrames (jmax (0, maxFramesPerSize))
+{
+}
+
+Image FramePool::acquire (Image::PixelFormat format, int width, int height, bool clear)
+{
+    const ScopedLock sl (lock);
+
+    auto& list = images [{ format, width, height }];
+
+    for (auto& image : list)
+    {
+        if (image.getReferenceCount() == 1)
+        {
+            ++reuses;
+
+            if (clear)
+                image.clear (image.getBounds());
+
+            return image;
+        }
+    }
+
+    ++allocations;
+    Image image (format, width, height, clear, SoftwareImageType());
+
+    // when all frames are in use the new one is not kept
+    if (int (list.size()) < maxFrames)
+        list.push_back (image);
+
+    return image;
+}
+
+void FramePool::releaseUnused()
+{
+    const ScopedLock sl (lock);
+
+    for (auto& list : images)
+        list.second.erase (std::remove_if (list.second.begin(), list.second.end(),
+                                           [](const Image& image) { return image.getReferenceCount() == 1; }),
+                           list.second.end());
+}
+
+int64 FramePool::getNumAllocations() const
+{
+    return allocations.load();
+}
+
+int64 FramePool::getNumReuses() const
+{
+    return reuses.load();
+}
+
+void FramePool::resetCounters()
+{
+    allocations.store (0);
+    reuses.store (0);
+}
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    FramePool.h
+    Created: 17 Oct 2026 8:54:18pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    Recycles frame images of the same size and format. An image in the pool is
+    free again once the pool holds the last reference to it, so the frames can
+    be passed around like any other Image and go back when they are dropped.
+    A pool keeping 0 frames per size allocates each time, but still counts.
+*/
+class FramePool
+{
+public:
+    FramePool (int maxFramesPerSize = 8);
+
+    /** Returns a free image from the pool, or a new one. The content is undefined unless clear is true. */
+    Image acquire (Image::PixelFormat format, int width, int height, bool clear = false);
+
+    /** Drops all images that are not in use */
+    void releaseUnused();
+
+    int64 getNumAllocations() const;
+    int64 getNumReuses() const;
+    void resetCounters();
+
+private:
+
+    struct Key
+    {
+        Image::PixelFormat format;
+        int width;
+        int height;
+
+        bool operator< (const Key& other) const
+        {
+            return std::tie (format, width, height) < std::tie (other.format, other.width, other.height);
+        }
+    };
+
+    CriticalSection lock;
+    std::map<Key, std::vector<Image>> images;
+    const int maxFrames;
+
+    std::atomic<int64> allocations { 0 };
+    std::atomic<int64> reuses      { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FramePool)
+};
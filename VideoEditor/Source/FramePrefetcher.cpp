@@ -0,0 +1,629 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    FramePrefetcher.cpp
+    Created: 17 Oct 2026 8:51:09pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+#include "FramePrefetcher.h"
+
+//==============================================================================
+
+class FramePrefetcher::Worker  : public ThreadPoolJob
+{
+public:
+    /** The worker creates its copy itself, so opening the media doesn't block the message thread */
+    Worker (FramePrefetcher& ownerToUse, std::function<std::shared_ptr<foleys::AVClip>()> createCopyToUse)
+      : ThreadPoolJob ("Frame prefetch"),
+        owner (ownerToUse),
+        createCopy (std::move (createCopyToUse))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        if (copy == nullptr && createCopy)
+        {
+            copy = createCopy();
+            createCopy = nullptr;
+        }
+
+        if (copy == nullptr)
+            return jobHasFinished;
+
+        int generation = 0;
+        int64 first = 0;
+        int numFrames = 0;
+        Rectangle<int> size;
+
+        // the frames of a run are decoded in order by the same copy, so its decoder moves forward through the GOP
+        while (! shouldExit() && owner.claimFrames (*this, generation, first, numFrames, size))
+        {
+            for (auto index = first; index < first + numFrames; ++index)
+            {
+                if (shouldExit() || ! owner.isCurrent (generation))
+                    break;
+
+                const auto image = copy->getStillImage (index / owner.frameRate.load(), { size.getWidth(), size.getHeight() });
+                owner.storeFrame (generation, index, owner.toDisplayFormat (image));
+            }
+        }
+
+        return jobHasFinished;
+    }
+
+    // set under the owner's lock when the worker found nothing to claim and leaves the pool
+    bool exiting = false;
+
+private:
+    FramePrefetcher& owner;
+    std::function<std::shared_ptr<foleys::AVClip>()> createCopy;
+    std::shared_ptr<foleys::AVClip> copy;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Worker)
+};
+
+//==============================================================================
+
+FramePrefetcher::FramePrefetcher (foleys::VideoEngine& engine)
+  : videoEngine (engine),
+    threadPool (engine.getThreadPool())
+{
+}
+
+FramePrefetcher::~FramePrefetcher()
+{
+    stopTimer();
+    cancelPendingUpdate();
+    statusTree.removeListener (this);
+
+    for (auto* list : { &workers, &retiredWorkers })
+        for (auto& worker : *list)
+            worker->signalJobShouldExit();
+
+    // the workers reference this, so they must have stopped. They do after the frame they're decoding.
+    for (auto* list : { &workers, &retiredWorkers })
+        for (auto& worker : *list)
+            threadPool.removeJob (worker.get(), true, -1);
+}
+
+void FramePrefetcher::setClip (std::shared_ptr<foleys::AVClip> clipToUse)
+{
+    statusTree.removeListener (this);
+    statusTree = {};
+
+    clip = clipToUse;
+
+    if (auto composed = std::dynamic_pointer_cast<foleys::ComposedClip> (clip))
+    {
+        statusTree = composed->getStatusTree();
+        statusTree.addListener (this);
+
+        const auto& video = composed->getVideoSettings();
+        if (video.timebase > 0 && video.defaultDuration > 0)
+            setFrameRate (double (video.timebase) / video.defaultDuration);
+    }
+
+    stopTimer();
+    invalidate (true);
+    reset (clip != nullptr ? clip->getCurrentTimeInSeconds() : 0.0);
+}
+
+void FramePrefetcher::setSeekIndex (SeekIndex* index)
+{
+    seekIndex = index;
+    invalidate (false);
+}
+
+void FramePrefetcher::reset (double seconds)
+{
+    const auto index = getFrameIndex (seconds);
+    const auto keyframe = getFrameIndex (getKeyframeBefore (seconds));
+    playheadFrame.store (index);
+    lastShownFrame = -1;
+
+    {
+        const ScopedLock sl (lock);
+        seekFrames.insert (frames.begin(), frames.end());
+        frames.clear();
+        firstFrame = index;
+        seekFrame  = index;
+        keyframeFrame = keyframe < index ? keyframe : -1;
+        seekFrameReady = false;
+        trimFrames();
+    }
+
+    triggerAsyncUpdate();
+}
+
+void FramePrefetcher::setPlayhead (double seconds)
+{
+    const auto index = getFrameIndex (seconds);
+    if (playheadFrame.exchange (index) != index)
+        triggerAsyncUpdate();
+}
+
+void FramePrefetcher::setPreroll (double seconds)
+{
+    seconds = jmax (-1.0, seconds);
+
+    const ScopedLock sl (lock);
+    if (seconds == prerollTime)
+        return;
+
+    prerollTime = seconds;
+    prerollFrames.clear();
+    triggerAsyncUpdate();
+}
+
+Image FramePrefetcher::getFrame (double seconds)
+{
+    const auto index = getFrameIndex (seconds);
+
+    Image image;
+    {
+        const ScopedLock sl (lock);
+        auto it = frames.find (index);
+        if (it != frames.end())
+            image = it->second;
+
+        if (! image.isValid())
+        {
+            it = seekFrames.find (index);
+            if (it != seekFrames.end())
+                image = it->second;
+        }
+
+        if (! image.isValid())
+        {
+            it = prerollFrames.find (index);
+            if (it != prerollFrames.end())
+                image = it->second;
+        }
+
+        // show the keyframe while the seek target is still decoding
+        if (! image.isValid() && index == seekFrame && keyframeFrame >= 0)
+        {
+            it = seekFrames.find (keyframeFrame);
+            if (it != seekFrames.end())
+            {
+                if (index != lastShownFrame)
+                    ++misses;
+
+                lastShownFrame = index;
+                return it->second;
+            }
+        }
+    }
+
+    if (index != lastShownFrame)
+    {
+        if (image.isValid())
+            ++hits;
+        else
+            ++misses;
+
+        if (lastShownFrame >= 0 && index > lastShownFrame + 1)
+            dropped += index - lastShownFrame - 1;
+
+        lastShownFrame = index;
+    }
+
+    return image;
+}
+
+void FramePrefetcher::setFrameSize (int width, int height)
+{
+    Rectangle<int> size;
+
+    if (clip != nullptr && width > 0 && height > 0)
+    {
+        const auto videoSize = clip->getVideoSize();
+        if (videoSize.width > 0 && videoSize.height > 0)
+            size = RectanglePlacement (RectanglePlacement::centred)
+                     .appliedTo (Rectangle<int> (videoSize.width, videoSize.height), Rectangle<int> (width, height))
+                     .withZeroOrigin();
+    }
+
+    const ScopedLock sl (lock);
+    if (size == frameSize)
+        return;
+
+    frameSize = size;
+    ++generation;
+    frames.clear();
+    seekFrames.clear();
+    prerollFrames.clear();
+    inFlight.clear();
+
+    // the frames of the previous size won't be asked for again
+    framePool.releaseUnused();
+
+    triggerAsyncUpdate();
+}
+
+void FramePrefetcher::setWindowSize (int numFrames)
+{
+    const ScopedLock sl (lock);
+    windowSize = jmax (1, numFrames);
+    trimFrames();
+    triggerAsyncUpdate();
+}
+
+void FramePrefetcher::setMemoryBudget (int64 bytes)
+{
+    const ScopedLock sl (lock);
+    memoryBudget = jmax (int64 (0), bytes);
+    trimFrames();
+}
+
+void FramePrefetcher::setFrameRate (double framesPerSecond)
+{
+    if (framesPerSecond > 0.0)
+    {
+        // the frame numbers change their meaning
+        invalidate (false);
+        frameRate.store (framesPerSecond);
+        reset (playheadFrame.load() / framesPerSecond);
+    }
+}
+
+void FramePrefetcher::setNumWorkers (int numWorkers)
+{
+    numWorkersToUse = jmax (1, numWorkers);
+    invalidate (true);
+}
+
+int64 FramePrefetcher::getNumHits() const
+{
+    return hits.load();
+}
+
+int64 FramePrefetcher::getNumMisses() const
+{
+    return misses.load();
+}
+
+int64 FramePrefetcher::getNumDroppedFrames() const
+{
+    return dropped.load();
+}
+
+void FramePrefetcher::resetCounters()
+{
+    hits.store (0);
+    misses.store (0);
+    dropped.store (0);
+}
+
+//==============================================================================
+
+int64 FramePrefetcher::getFrameIndex (double seconds) const
+{
+    return int64 (std::floor (seconds * frameRate.load() + 0.001));
+}
+
+int64 FramePrefetcher::getPrerollFrame() const
+{
+    return prerollTime < 0.0 ? int64 (-1) : getFrameIndex (prerollTime);
+}
+
+bool FramePrefetcher::isInPreroll (int64 index) const
+{
+    const auto prerollFrame = getPrerollFrame();
+    return prerollFrame >= 0 && index >= prerollFrame && index < prerollFrame + windowSize;
+}
+
+bool FramePrefetcher::claimFrames (Worker& worker, int& generationToRender, int64& first, int& numFrames, Rectangle<int>& size)
+{
+    const ScopedLock sl (lock);
+
+    // decided under the lock, so handleAsyncUpdate sees a worker that is about to leave the pool
+    worker.exiting = ! claimNextRun (generationToRender, first, numFrames, size);
+    return ! worker.exiting;
+}
+
+bool FramePrefetcher::claimNextRun (int& generationToRender, int64& first, int& numFrames, Rectangle<int>& size)
+{
+    // stale copies would render the edit as it was
+    if (frameSize.isEmpty() || copiesStale)
+        return false;
+
+    auto isMissing = [this](int64 i)
+    {
+        return frames.find (i) == frames.end() && seekFrames.find (i) == seekFrames.end() && prerollFrames.find (i) == prerollFrames.end();
+    };
+
+    generationToRender = generation;
+    size      = frameSize;
+    numFrames = 0;
+
+    // the keyframe needs no decoding of other frames, so it is ready first
+    if (keyframeFrame >= 0 && isMissing (keyframeFrame) && inFlight.insert (keyframeFrame).second)
+    {
+        first = keyframeFrame;
+        numFrames = 1;
+        return true;
+    }
+
+    // each worker takes a run of consecutive frames, so the workers don't decode the same GOP
+    const auto runLength = jmax (1, windowSize / jmax (1, numWorkersToUse));
+
+    auto claimRun = [&](int64 begin, int64 end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            if (! isMissing (i) || inFlight.find (i) != inFlight.end())
+                continue;
+
+            first = i;
+            while (i < end && numFrames < runLength && isMissing (i) && inFlight.insert (i).second)
+            {
+                ++i;
+                ++numFrames;
+            }
+
+            return true;
+        }
+
+        return false;
+    };
+
+    // the frames closest to the playhead first, the preroll when the window is complete
+    if (claimRun (firstFrame, firstFrame + windowSize))
+        return true;
+
+    // the preroll only gets what the budget has left besides the window
+    const auto prerollFrame = getPrerollFrame();
+    const auto prerollRoom  = jmin (int64 (windowSize), int64 (getFrameBudget()) - windowSize);
+    return prerollFrame >= 0 && prerollRoom > 0 && claimRun (prerollFrame, prerollFrame + prerollRoom);
+}
+
+bool FramePrefetcher::isCurrent (int generationRendering)
+{
+    const ScopedLock sl (lock);
+    return generationRendering == generation;
+}
+
+void FramePrefetcher::storeFrame (int generationRendered, int64 index, const Image& image)
+{
+    const ScopedLock sl (lock);
+
+    if (generationRendered != generation)
+        return;
+
+    inFlight.erase (index);
+
+    if (! image.isValid())
+        return;
+
+    // preroll frames are kept, frames of a previous window belong to a recent seek target
+    if (isInPreroll (index))
+        prerollFrames [index] = image;
+    else if (index >= firstFrame && index < firstFrame + windowSize)
+        frames [index] = image;
+    else
+        seekFrames [index] = image;
+
+    trimFrames();
+
+    if (index == seekFrame || index == keyframeFrame)
+    {
+        seekFrameReady = true;
+        triggerAsyncUpdate();
+    }
+}
+
+Image FramePrefetcher::toDisplayFormat (const Image& image)
+{
+    // drawing an RGB image converts it on the message thread each time it is painted
+    if (image.getFormat() == Image::RGB)
+        return Compositor::convertToARGB (image, &framePool);
+
+    return image;
+}
+
+size_t FramePrefetcher::getFrameBudget() const
+{
+    // all frames have the size of the preview and are ARGB
+    const auto frameBytes = jmax (int64 (1), int64 (frameSize.getWidth()) * frameSize.getHeight() * 4);
+    return size_t (jmax (int64 (windowSize), memoryBudget / frameBytes));
+}
+
+void FramePrefetcher::trimFrames()
+{
+    const auto budget = getFrameBudget();
+    auto numFrames = [this] { return frames.size() + seekFrames.size() + prerollFrames.size(); };
+
+    // drop the frames furthest away from the last seek target, but not the keyframe shown until it arrives
+    while (seekFrames.size() > size_t (numSeekWindows * windowSize) || (! seekFrames.empty() && numFrames() > budget))
+    {
+        auto first = seekFrames.begin();
+        auto last  = std::prev (seekFrames.end());
+        auto furthest = seekFrame - first->first > last->first - seekFrame ? first : last;
+
+        if (furthest->first == keyframeFrame)
+        {
+            if (first == last)
+                break;
+
+            furthest = furthest == first ? last : first;
+        }
+
+        seekFrames.erase (furthest);
+    }
+
+    // the preroll is shortened from its end, its start is shown first after the jump
+    while (! prerollFrames.empty() && numFrames() > budget)
+        prerollFrames.erase (std::prev (prerollFrames.end()));
+}
+
+double FramePrefetcher::getKeyframeBefore (double seconds) const
+{
+    if (seekIndex == nullptr || clip == nullptr)
+        return seconds;
+
+    auto composed = std::dynamic_pointer_cast<foleys::ComposedClip> (clip);
+    if (composed == nullptr)
+        return seekIndex->getKeyframeBefore (clip->getMediaFile(), seconds);
+
+    // rendering the frame needs all clips decoded from their keyframes
+    auto keyframe = seconds;
+    for (const auto& descriptor : composed->getClips())
+    {
+        const auto start = descriptor->getStart();
+        if (! descriptor->clip->hasVideo() || seconds < start || seconds >= start + descriptor->getLength())
+            continue;
+
+        const auto offset = descriptor->getOffset();
+        const auto local  = seekIndex->getKeyframeBefore (descriptor->clip->getMediaFile(), seconds - start + offset);
+        keyframe = jmin (keyframe, jmax (start, local + start - offset));
+    }
+
+    return keyframe;
+}
+
+void FramePrefetcher::requestSeekIndices()
+{
+    if (seekIndex == nullptr || clip == nullptr)
+        return;
+
+    if (auto composed = std::dynamic_pointer_cast<foleys::ComposedClip> (clip))
+    {
+        for (const auto& descriptor : composed->getClips())
+            if (descriptor->clip->hasVideo())
+                seekIndex->requestIndex (descriptor->clip->getMediaFile());
+    }
+    else if (clip->hasVideo())
+    {
+        seekIndex->requestIndex (clip->getMediaFile());
+    }
+}
+
+void FramePrefetcher::invalidate (bool staleCopies)
+{
+    {
+        const ScopedLock sl (lock);
+        ++generation;
+        frames.clear();
+        seekFrames.clear();
+        prerollFrames.clear();
+        inFlight.clear();
+        keyframeFrame = -1;
+        copiesStale = copiesStale || staleCopies;
+    }
+
+    triggerAsyncUpdate();
+}
+
+void FramePrefetcher::editChanged()
+{
+    invalidate (true);
+    startTimer (rebuildDelay);
+}
+
+void FramePrefetcher::timerCallback()
+{
+    stopTimer();
+    triggerAsyncUpdate();
+}
+
+void FramePrefetcher::handleAsyncUpdate()
+{
+    retiredWorkers.erase (std::remove_if (retiredWorkers.begin(), retiredWorkers.end(),
+                                          [this](const auto& worker) { return ! threadPool.contains (worker.get()); }),
+                          retiredWorkers.end());
+
+    bool needsCopies = false;
+    bool seekFrameArrived = false;
+    {
+        const ScopedLock sl (lock);
+        seekFrameArrived = std::exchange (seekFrameReady, false);
+        firstFrame = playheadFrame.load();
+        frames.erase (frames.begin(), frames.lower_bound (firstFrame));
+        frames.erase (frames.lower_bound (firstFrame + windowSize), frames.end());
+
+        // while the edit is being changed the copies wait until it settled
+        needsCopies = copiesStale && ! isTimerRunning();
+        if (needsCopies)
+            copiesStale = false;
+    }
+
+    if (needsCopies)
+    {
+        // workers still rendering finish in the background and are deleted later
+        for (auto& worker : workers)
+        {
+            worker->signalJobShouldExit();
+            retiredWorkers.push_back (std::move (worker));
+        }
+
+        workers.clear();
+        requestSeekIndices();
+
+        // only the tree is copied here, each worker opens the media of its copy itself
+        auto composed = std::dynamic_pointer_cast<foleys::ComposedClip> (clip);
+
+        for (int i = 0; clip != nullptr && i < numWorkersToUse; ++i)
+        {
+            std::function<std::shared_ptr<foleys::AVClip>()> createCopy;
+
+            if (composed != nullptr)
+                createCopy = [&engine = videoEngine, tree = composed->getStatusTree().createCopy()]
+                {
+                    return std::shared_ptr<foleys::AVClip> (EditFile::createEdit (engine, tree));
+                };
+            else
+                createCopy = [source = clip] { return source->createCopy (foleys::StreamTypes::video()); };
+
+            workers.push_back (std::make_unique<Worker> (*this, std::move (createCopy)));
+        }
+    }
+
+    // A worker that found nothing to claim stays in the pool for a moment and can't be
+    // added again until it left. The update repeats until then, so new frames aren't left waiting.
+    auto recheck = false;
+    {
+        const ScopedLock sl (lock);
+
+        for (auto& worker : workers)
+        {
+            if (! threadPool.contains (worker.get()))
+            {
+                worker->exiting = false;
+                threadPool.addJob (worker.get(), false);
+            }
+            else if (worker->exiting)
+            {
+                recheck = true;
+            }
+        }
+    }
+
+    if (recheck)
+        triggerAsyncUpdate();
+
+    if (seekFrameArrived && onSeekFrameReady)
+        onSeekFrameReady();
+}
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    FramePrefetcher.h
+    Created: 17 Oct 2026 8:50:52pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Compositor.h"
+#include "SeekIndex.h"
+
+//==============================================================================
+/*
+    Keeps a window of composited frames ahead of the playhead. The frames are
+    rendered by workers on the engine's ThreadPool, each one with its own copy
+    of the edit, so they don't compete for the decoders of the edit that is
+    playing. Each worker renders runs of consecutive frames. The copies are
+    recreated by the workers once the edit stopped changing for a moment.
+
+    After a seek the frames of the previous window are kept around, so
+    scrubbing back and forth finds them again. With a SeekIndex the keyframe
+    before the seek target is rendered first and shown until the target
+    frame arrives. The frames after a preroll time, e.g. a loop start, are
+    rendered ahead and kept until the edit changes.
+
+    Frames the engine delivers in RGB are converted to ARGB once by the
+    worker, instead of by every paint. The converted images come from a
+    FramePool and go back to it when they drop out of the window.
+
+    All frames kept share a memory budget. The window ahead of the playhead
+    always fits, the frames of recent seek targets and the preroll are
+    dropped when they would exceed it.
+
+    The counters tell how many frames were shown from the window (hits), how
+    many had to be decoded on demand (misses) and how many were skipped.
+*/
+class FramePrefetcher  : private AsyncUpdater,
+                         private ValueTree::Listener,
+                         private Timer
+{
+public:
+    FramePrefetcher (foleys::VideoEngine& videoEngine);
+    ~FramePrefetcher();
+
+    void setClip (std::shared_ptr<foleys::AVClip> clip);
+
+    /** Set an index to look up the keyframes of the media in the clip, can be nullptr */
+    void setSeekIndex (SeekIndex* index);
+
+    /** Moves the window to seconds, the frames around recent seek targets are kept */
+    void reset (double seconds);
+
+    /** Moves the window along with the playhead, can be called from any thread */
+    void setPlayhead (double seconds);
+
+    /** Renders a window of frames from seconds ahead, so a jump there shows them at once. -1 switches it off */
+    void setPreroll (double seconds);
+
+    /** Returns the frame for the time, or an invalid Image if it wasn't rendered in time */
+    Image getFrame (double seconds);
+
+    /** Set the size of the frames to render, usually the size of the preview */
+    void setFrameSize (int width, int height);
+
+    void setWindowSize (int numFrames);
+
+    /** Set the memory for all frames kept, it is raised to fit at least the window */
+    void setMemoryBudget (int64 bytes);
+    void setFrameRate (double framesPerSecond);
+    void setNumWorkers (int numWorkers);
+
+    /** Returns the latest keyframe before seconds of all video clips at that time */
+    double getKeyframeBefore (double seconds) const;
+
+    /** Called on the message thread when the keyframe or the frame of the last seek target arrived */
+    std::function<void()> onSeekFrameReady;
+
+    int64 getNumHits() const;
+    int64 getNumMisses() const;
+    int64 getNumDroppedFrames() const;
+    void resetCounters();
+
+private:
+
+    class Worker;
+
+    /** Claims a run of consecutive frames to render, the worker is marked as exiting if there is none */
+    bool claimFrames (Worker& worker, int& generation, int64& first, int& numFrames, Rectangle<int>& size);
+    bool claimNextRun (int& generation, int64& first, int& numFrames, Rectangle<int>& size);
+    bool isCurrent (int generation);
+    void storeFrame (int generation, int64 index, const Image& image);
+    Image toDisplayFormat (const Image& image);
+    void invalidate (bool copiesStale);
+    void trimFrames();
+    size_t getFrameBudget() const;
+    void requestSeekIndices();
+
+    int64 getFrameIndex (double seconds) const;
+    int64 getPrerollFrame() const;
+    bool isInPreroll (int64 index) const;
+
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+
+    /** Drops the frames, the copies are rebuilt after rebuildDelay without further changes */
+    void editChanged();
+
+    void valueTreePropertyChanged (ValueTree&, const Identifier&) override   { editChanged(); }
+    void valueTreeChildAdded (ValueTree&, ValueTree&) override               { editChanged(); }
+    void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override        { editChanged(); }
+    void valueTreeChildOrderChanged (ValueTree&, int, int) override          { editChanged(); }
+    void valueTreeParentChanged (ValueTree&) override {}
+
+    foleys::VideoEngine& videoEngine;
+    ThreadPool& threadPool;
+    std::shared_ptr<foleys::AVClip> clip;
+    ValueTree statusTree;
+
+    static constexpr int rebuildDelay = 300;
+
+    CriticalSection lock;
+    std::map<int64, Image> frames;
+    std::set<int64> inFlight;
+    std::map<int64, Image> seekFrames;
+    std::map<int64, Image> prerollFrames;
+    double prerollTime  = -1.0;
+    int64 seekFrame     = -1;
+    int64 keyframeFrame = -1;
+    bool  seekFrameReady = false;
+    int   generation  = 0;
+    int64 firstFrame  = 0;
+    int   windowSize  = 25;
+    Rectangle<int> frameSize;
+    bool  copiesStale = true;
+
+    FramePool framePool { 64 };
+    int64 memoryBudget = 256 * 1024 * 1024;
+
+    SeekIndex* seekIndex = nullptr;
+    static constexpr int numSeekWindows = 4;
+
+    std::atomic<double> frameRate { 25.0 };
+    std::atomic<int64>  playheadFrame { 0 };
+
+    int numWorkersToUse = jlimit (1, 4, SystemStats::getNumCpus() / 2);
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::unique_ptr<Worker>> retiredWorkers;
+
+    int64 lastShownFrame = -1;
+    std::atomic<int64> hits    { 0 };
+    std::atomic<int64> misses  { 0 };
+    std::atomic<int64> dropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FramePrefetcher)
+};
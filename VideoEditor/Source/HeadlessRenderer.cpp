@@ -0,0 +1,505 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    HeadlessRenderer.cpp
+    Created: 17 Oct 2026 8:31:35pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Compositor.h"
+#include "EditFile.h"
+#include "HeadlessRenderer.h"
+#include "PeakCache.h"
+#include "Player.h"
+#include "Properties.h"
+#include "RenderPresets.h"
+#include "SegmentRenderer.h"
+#include "ThumbnailCache.h"
+#include "TimeLine.h"
+
+#include <deque>
+#include <iostream>
+
+//==============================================================================
+HeadlessRenderer::HeadlessRenderer()
+{
+    videoEngine.getAudioPluginManager().setPluginDataFile (EditFile::getSettingsFolder().getChildFile ("PluginList.xml"));
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+    renderer.onRenderingFinished = nullptr;
+    renderer.cancelRendering();
+}
+
+const std::vector<HeadlessRenderer::Benchmark>& HeadlessRenderer::getBenchmarks()
+{
+    static const std::vector<Benchmark> benchmarks
+    {
+        { "--benchmark-project",     &HeadlessRenderer::benchmarkProject },
+        { "--benchmark-timeline",    &HeadlessRenderer::benchmarkTimeLine },
+        { "--benchmark-compositing", &HeadlessRenderer::benchmarkCompositing },
+        { "--benchmark-frames",      &HeadlessRenderer::benchmarkFramePool }
+    };
+
+    return benchmarks;
+}
+
+bool HeadlessRenderer::isRenderCommandLine (const StringArray& args)
+{
+    if (args.contains ("--render"))
+        return true;
+
+    for (const auto& benchmark : getBenchmarks())
+        if (args.contains (benchmark.option))
+            return true;
+
+    return false;
+}
+
+bool HeadlessRenderer::start (const StringArray& args)
+{
+    for (const auto& benchmark : getBenchmarks())
+        if (args.contains (benchmark.option))
+            return runBenchmark (benchmark, args);
+
+    auto editFile = getFileArgument (args, "--render");
+    outputFile    = getFileArgument (args, "--out");
+
+    if (editFile == File() || outputFile == File())
+    {
+        std::cerr << "Usage: " << ProjectInfo::projectName << " --render <edit.videdit> --out <file.mp4> [--preset <name>]"
+                  << " [--segments <number>] [--ffmpeg <executable>] [--benchmark] [--stats <file.jsonl>]" << std::endl;
+        return false;
+    }
+
+    edit = EditFile::load (videoEngine, editFile);
+    if (edit == nullptr)
+    {
+        std::cerr << "Loading of the file \"" << editFile.getFullPathName() << "\" failed." << std::endl;
+        return false;
+    }
+
+    auto settings = RenderPresets::createDefaultSettings();
+    auto presetName = getArgument (args, "--preset");
+    if (presetName.isNotEmpty())
+    {
+        RenderPresets presets;
+        settings = presets.getPreset (presetName);
+        if (! settings.isValid())
+        {
+            std::cerr << "Unknown preset \"" << presetName << "\", available are: " << presets.getPresetNames().joinIntoString (", ") << std::endl;
+            return false;
+        }
+    }
+
+    renderer.setClipToRender (edit);
+    renderer.setRenderSettings (settings);
+
+    if (args.contains ("--ffmpeg"))
+        renderer.setFFmpegExecutable (getArgument (args, "--ffmpeg"));
+
+    statsFile = getFileArgument (args, "--stats");
+
+    if (args.contains ("--benchmark"))
+    {
+        // render with 1, 2, 4... segments up to one per core to see how it scales
+        const auto numCpus = SystemStats::getNumCpus();
+        for (int numSegments = 1; numSegments < numCpus; numSegments *= 2)
+            benchmarkRuns.push_back (numSegments);
+
+        benchmarkRuns.push_back (numCpus);
+    }
+    else
+    {
+        renderer.setNumSegments (getIntArgument (args, "--segments", 1, 0));
+    }
+
+    renderer.onRenderingFinished = [this](bool success)
+    {
+        finish (success);
+    };
+
+    std::cout << "Rendering \"" << editFile.getFullPathName() << "\" to \"" << outputFile.getFullPathName() << "\"" << std::endl;
+
+    return startNextRun();
+}
+
+bool HeadlessRenderer::runBenchmark (const Benchmark& benchmark, const StringArray& args)
+{
+    if (! (this->*benchmark.run) (args))
+        return false;
+
+    // the results are printed already, the application quits once its message loop runs
+    MessageManager::callAsync ([this]
+    {
+        if (onFinished)
+            onFinished (0);
+    });
+
+    return true;
+}
+
+bool HeadlessRenderer::benchmarkProject (const StringArray& args)
+{
+    auto editFile = getFileArgument (args, "--benchmark-project");
+    auto numRuns  = getIntArgument (args, "--runs", 5, 1);
+
+    edit = EditFile::load (videoEngine, editFile);
+    if (edit == nullptr)
+    {
+        std::cerr << "Loading of the file \"" << editFile.getFullPathName() << "\" failed." << std::endl;
+        return false;
+    }
+
+    std::cout << "Benchmarking \"" << editFile.getFullPathName() << "\" with " << edit->getClips().size() << " clips" << std::endl;
+
+    const std::vector<std::pair<EditFile::Format, String>> formats
+    {
+        { EditFile::Format::xml,        "XML" },
+        { EditFile::Format::binary,     "Binary" },
+        { EditFile::Format::compressed, "Compressed" }
+    };
+
+    for (const auto& format : formats)
+    {
+        TemporaryFile temp (editFile);
+        auto saveTime = 0.0;
+        auto loadTime = 0.0;
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            auto start = Time::getMillisecondCounterHiRes();
+            if (! EditFile::save (*edit, temp.getFile(), format.first))
+            {
+                std::cerr << "Saving " << format.second << " failed." << std::endl;
+                return false;
+            }
+
+            saveTime += Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            if (EditFile::load (videoEngine, temp.getFile()) == nullptr)
+            {
+                std::cerr << "Loading " << format.second << " failed." << std::endl;
+                return false;
+            }
+
+            loadTime += Time::getMillisecondCounterHiRes() - start;
+        }
+
+        std::cout << format.second << ": save " << String (saveTime / numRuns, 1) << " ms, load "
+                  << String (loadTime / numRuns, 1) << " ms, size "
+                  << File::descriptionOfSizeInBytes (temp.getFile().getSize()) << std::endl;
+    }
+
+    return true;
+}
+
+bool HeadlessRenderer::benchmarkTimeLine (const StringArray& args)
+{
+    const auto maxClips = getIntArgument (args, "--clips", 10000, 1);
+
+    AudioDeviceManager   deviceManager;
+    PrefetchedPreview    preview    { videoEngine };
+    Player               player     { deviceManager, videoEngine, preview };
+    Properties           properties;
+    Viewport             viewport;
+    ThumbnailCache       thumbnailCache;
+    PeakCache            peakCache  { videoEngine.getAudioFormatManager() };
+    ProxyManager         proxyManager;
+    TimeLine             timeline   { videoEngine, player, properties, thumbnailCache, peakCache, proxyManager };
+
+    viewport.setSize (1600, 510);
+    viewport.setViewedComponent (&timeline, false);
+    timeline.setSize (2000, 510);
+
+    edit = std::make_shared<foleys::ComposedClip>(videoEngine);
+    videoEngine.manageLifeTime (edit);
+    timeline.setEditClip (edit);
+
+    auto measure = [](std::function<void()> change)
+    {
+        const auto start = Time::getMillisecondCounterHiRes();
+        change();
+        return Time::getMillisecondCounterHiRes() - start;
+    };
+
+    // an empty ComposedClip is the cheapest clip with video and audio
+    auto addClip = [this](int index)
+    {
+        return edit->addClip (std::make_shared<foleys::ComposedClip>(videoEngine), index * 2.0, 3.0);
+    };
+
+    std::vector<int> checkpoints;
+    for (int count = 10; count < maxClips; count *= 10)
+        checkpoints.push_back (count);
+
+    checkpoints.push_back (maxClips);
+
+    int numClips = 0;
+    for (auto checkpoint : checkpoints)
+    {
+        while (numClips < checkpoint)
+            addClip (numClips++);
+
+        timeline.updateClipsNow();
+        const auto full = measure ([&timeline] { timeline.restoreClipComponents(); });
+
+        // a single change only updates the entries of that clip
+        std::shared_ptr<foleys::ClipDescriptor> added;
+        const auto addOne = measure ([&]
+        {
+            added = addClip (numClips);
+            timeline.updateClipsNow();
+        });
+
+        const auto removeOne = measure ([&]
+        {
+            edit->removeClip (added);
+            timeline.updateClipsNow();
+        });
+
+        std::cout << numClips << " clips: restore " << String (full, 3) << " ms, add one " << String (addOne, 3)
+                  << " ms, remove one " << String (removeOne, 3) << " ms" << std::endl;
+    }
+
+    timeline.setEditClip ({});
+    edit.reset();
+
+    return true;
+}
+
+bool HeadlessRenderer::benchmarkCompositing (const StringArray& args)
+{
+    const auto numLanes = getIntArgument (args, "--lanes", 3, 2);
+    const auto numRuns  = getIntArgument (args, "--runs", 50, 1);
+
+    Random random;
+    std::vector<Image> lanes;
+    for (int i = 0; i < numLanes; ++i)
+    {
+        Image lane (Image::ARGB, 1920, 1080, false);
+        Image::BitmapData data (lane, Image::BitmapData::writeOnly);
+
+        // premultiplied, so no channel exceeds the alpha
+        for (int y = 0; y < data.height; ++y)
+        {
+            for (int x = 0; x < data.width; ++x)
+            {
+                const auto alpha = random.nextInt (256);
+                reinterpret_cast<PixelARGB*> (data.getPixelPointer (x, y))->setARGB (uint8 (alpha),
+                                                                                     uint8 (random.nextInt (alpha + 1)),
+                                                                                     uint8 (random.nextInt (alpha + 1)),
+                                                                                     uint8 (random.nextInt (alpha + 1)));
+            }
+        }
+
+        lanes.push_back (lane);
+    }
+
+    Compositor compositor;
+
+    auto measure = [&]
+    {
+        auto frame = lanes.front().createCopy();
+        const auto start = Time::getMillisecondCounterHiRes();
+
+        for (int run = 0; run < numRuns; ++run)
+            for (size_t i = 1; i < lanes.size(); ++i)
+                compositor.blend (frame, lanes [i], 0.8f);
+
+        return (Time::getMillisecondCounterHiRes() - start) / numRuns;
+    };
+
+    std::cout << "Compositing " << numLanes << " lanes of 1920x1080, " << numRuns << " frames" << std::endl;
+
+    compositor.setKernel (Compositor::Kernel::scalar);
+    compositor.setNumTiles (1);
+    const auto reference = measure();
+    std::cout << "scalar, 1 tile: " << String (reference, 3) << " ms per frame" << std::endl;
+
+    compositor.setKernel (Compositor::getBestKernel());
+    for (auto tiles : { 1, SystemStats::getNumCpus() })
+    {
+        compositor.setNumTiles (tiles);
+        const auto time = measure();
+        std::cout << Compositor::getKernelName (compositor.getKernel()) << ", " << tiles << " tiles: "
+                  << String (time, 3) << " ms per frame, " << String (reference / time, 2) << "x" << std::endl;
+    }
+
+    return true;
+}
+
+bool HeadlessRenderer::benchmarkFramePool (const StringArray& args)
+{
+    const auto numFrames = getIntArgument (args, "--frames", 500, 1);
+
+    Image decoded (Image::RGB, 1920, 1080, true);
+    FramePool pool;
+    FramePool unpooled { 0 };
+    Compositor compositor;
+
+    std::cout << "Converting " << numFrames << " frames of 1920x1080, keeping the last 3 like a preview queue" << std::endl;
+
+    // both paths take their images from a FramePool, the one keeping no frames allocates each time
+    for (auto usePool : { false, true })
+    {
+        auto& framePool = usePool ? pool : unpooled;
+        compositor.setFramePool (&framePool);
+        framePool.resetCounters();
+
+        std::deque<Image> queue;
+        const auto start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            queue.push_back (compositor.convertToARGB (decoded));
+            if (queue.size() > 3)
+                queue.pop_front();
+        }
+
+        const auto seconds = (Time::getMillisecondCounterHiRes() - start) / 1000.0;
+        const auto allocations = framePool.getNumAllocations();
+
+        std::cout << (usePool ? "pooled: " : "new images: ") << String (numFrames / seconds, 1) << " frames/s, "
+                  << String (allocations / seconds, 1) << " allocations/s (" << allocations << " in total)" << std::endl;
+    }
+
+    return true;
+}
+
+bool HeadlessRenderer::startNextRun()
+{
+    auto runFile = outputFile;
+
+    if (! benchmarkRuns.empty())
+    {
+        const auto numSegments = benchmarkRuns.front();
+        benchmarkRuns.erase (benchmarkRuns.begin());
+
+        // each run keeps its own file, so the results can be compared afterwards
+        runFile = outputFile.getSiblingFile (outputFile.getFileNameWithoutExtension() + "-" + String (numSegments)
+                                             + "segments" + outputFile.getFileExtension());
+        renderer.setNumSegments (numSegments);
+    }
+
+    if (runFile.existsAsFile() && ! runFile.deleteFile())
+    {
+        std::cerr << "Cannot overwrite \"" << runFile.getFullPathName() << "\"." << std::endl;
+        return false;
+    }
+
+    renderer.setOutputFile (runFile);
+
+    lastReportedPercent = -1;
+    startTime = Time::getMillisecondCounterHiRes();
+
+    if (! renderer.startRendering())
+        return false;
+
+    std::cout << "Segments: " << renderer.getNumActiveSegments() << std::endl;
+
+    startTimer (1000);
+    return true;
+}
+
+void HeadlessRenderer::timerCallback()
+{
+    const auto& stats = renderer.getStats();
+    auto percent = roundToInt (stats.getProgress() * 100.0);
+    if (percent != lastReportedPercent)
+    {
+        std::cout << "Progress: " << percent << "%, " << String (stats.getFramesPerSecond(), 1) << " frames/s, "
+                  << "remaining: " << RelativeTime (stats.getRemainingSeconds()).getDescription() << std::endl;
+        lastReportedPercent = percent;
+    }
+
+    writeStats();
+}
+
+void HeadlessRenderer::writeStats()
+{
+    if (statsFile != File())
+        statsFile.appendText (renderer.getStats().toJsonLine() + "\n");
+}
+
+void HeadlessRenderer::finish (bool success)
+{
+    stopTimer();
+    writeStats();
+
+    if (success)
+    {
+        const auto seconds = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+        const auto frames  = edit->getLengthInSeconds() / renderer.getFrameDuration();
+
+        std::cout << "Rendering finished: " << renderer.getOutputFile().getFullPathName() << std::endl;
+        std::cout << "Time: " << String (seconds, 2) << " s, " << String (frames / seconds, 1) << " frames/s, "
+                  << String (edit->getLengthInSeconds() / seconds, 2) << "x realtime" << std::endl;
+
+        const auto& stats = renderer.getStats();
+        for (int i = 0; i < RenderStats::numPhases; ++i)
+            std::cout << "  " << RenderStats::getPhaseName (RenderStats::Phase (i)) << ": "
+                      << String (stats.getPhaseSeconds (RenderStats::Phase (i)), 2) << " s" << std::endl;
+
+        if (! benchmarkRuns.empty())
+        {
+            if (startNextRun())
+                return;
+
+            success = false;
+        }
+    }
+
+    if (! success)
+        std::cerr << "Rendering failed." << std::endl;
+
+    if (onFinished)
+        onFinished (success ? 0 : 1);
+}
+
+String HeadlessRenderer::getArgument (const StringArray& args, const String& option)
+{
+    auto index = args.indexOf (option);
+    if (index < 0 || index + 1 >= args.size())
+        return {};
+
+    return args [index + 1].unquoted();
+}
+
+File HeadlessRenderer::getFileArgument (const StringArray& args, const String& option)
+{
+    auto path = getArgument (args, option);
+    if (path.isEmpty())
+        return {};
+
+    return File::getCurrentWorkingDirectory().getChildFile (path);
+}
+
+int HeadlessRenderer::getIntArgument (const StringArray& args, const String& option, int defaultValue, int minimum)
+{
+    if (! args.contains (option))
+        return defaultValue;
+
+    return jmax (minimum, getArgument (args, option).getIntValue());
+}
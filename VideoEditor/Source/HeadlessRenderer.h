@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    HeadlessRenderer.h
+    Created: 17 Oct 2026 8:31:35pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SegmentRenderer.h"
+
+//==============================================================================
+/*
+    Renders an edit from the command line without creating any window, audio
+    device or player, or runs one of the benchmarks:
+
+        VideoEditor --render <edit.videdit> --out <file.mp4> [--preset <name>]
+                    [--segments <number>] [--ffmpeg <executable>] [--benchmark]
+                    [--stats <file.jsonl>]
+
+        VideoEditor --benchmark-project <edit.videdit> [--runs <number>]
+        VideoEditor --benchmark-timeline [--clips <number>]
+        VideoEditor --benchmark-compositing [--lanes <number>] [--runs <number>]
+        VideoEditor --benchmark-frames [--frames <number>]
+
+    The preset names are the ones saved in the RenderDialog. With --segments
+    the edit is rendered in that many parallel segments, 0 means one per CPU
+    core. --benchmark renders with an increasing number of segments and
+    reports the throughput of each run, each run writes its own file named
+    after the output with the number of segments appended. With --stats the RenderStats are
+    appended to the file as one JSON object per line every second.
+
+    --benchmark-project saves and loads the edit in each of the EditFile
+    formats and reports the times and file sizes. --benchmark-timeline fills
+    an edit with up to 10000 clips and measures how long the TimeLine needs
+    to catch up with adding and removing clips. Unlike the others it creates
+    the TimeLine with a Player, preview and ProxyManager like the editor, only
+    without a window and without opening the audio device. --benchmark-compositing
+    blends 1080p lanes with the scalar Compositor kernel on one thread and
+    with the best SIMD kernel, untiled and tiled across all cores.
+    --benchmark-frames converts decoded frames with and without the FramePool
+    and reports the allocations per second.
+*/
+class HeadlessRenderer  : private Timer
+{
+public:
+    HeadlessRenderer();
+    ~HeadlessRenderer();
+
+    /** Returns true, if the arguments ask for a headless render instead of the editor */
+    static bool isRenderCommandLine (const StringArray& args);
+
+    /** Loads the edit and starts rendering. Returns false, if the job could not be started */
+    bool start (const StringArray& args);
+
+    /** Called on the message thread with the exit code when the job has finished */
+    std::function<void(int exitCode)> onFinished;
+
+    void timerCallback() override;
+
+private:
+
+    static String getArgument (const StringArray& args, const String& option);
+    static File getFileArgument (const StringArray& args, const String& option);
+
+    /** Returns the number after the option, at least minimum, or defaultValue if the option is missing */
+    static int getIntArgument (const StringArray& args, const String& option, int defaultValue, int minimum);
+
+    /*
+        A --benchmark-* mode. It runs synchronously and prints its results,
+        returning false if it could not run.
+    */
+    struct Benchmark
+    {
+        const char* option;
+        bool (HeadlessRenderer::*run) (const StringArray& args);
+    };
+
+    static const std::vector<Benchmark>& getBenchmarks();
+    bool runBenchmark (const Benchmark& benchmark, const StringArray& args);
+
+    bool benchmarkProject (const StringArray& args);
+    bool benchmarkTimeLine (const StringArray& args);
+    bool benchmarkCompositing (const StringArray& args);
+    bool benchmarkFramePool (const StringArray& args);
+    bool startNextRun();
+    void writeStats();
+    void finish (bool success);
+
+    foleys::VideoEngine   videoEngine;
+    SegmentRenderer       renderer { videoEngine };
+
+    std::shared_ptr<foleys::ComposedClip> edit;
+    std::vector<int> benchmarkRuns;
+    File   outputFile;
+    File   statsFile;
+    double startTime = 0.0;
+    int lastReportedPercent = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HeadlessRenderer)
+};
@@ -24,6 +24,7 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainComponent.h"
+#include "HeadlessRenderer.h"
 
 //==============================================================================
 class VideoEditorApplication  : public JUCEApplication
@@ -34,17 +35,41 @@ public:
 
     const String getApplicationName() override       { return ProjectInfo::projectName; }
     const String getApplicationVersion() override    { return ProjectInfo::versionString; }
-    bool moreThanOneInstanceAllowed() override       { return false; }
+    bool moreThanOneInstanceAllowed() override
+    {
+        // render jobs must not be forwarded to an already running editor
+        return HeadlessRenderer::isRenderCommandLine (getCommandLineParameterArray());
+    }
 
     //==============================================================================
     void initialise (const String& commandLine) override
     {
+        auto args = getCommandLineParameterArray();
+        if (HeadlessRenderer::isRenderCommandLine (args))
+        {
+            headlessRenderer = std::make_unique<HeadlessRenderer>();
+            headlessRenderer->onFinished = [this](int exitCode)
+            {
+                setApplicationReturnValue (exitCode);
+                quit();
+            };
+
+            if (! headlessRenderer->start (args))
+            {
+                setApplicationReturnValue (1);
+                quit();
+            }
+
+            return;
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
     void shutdown() override
     {
         mainWindow.reset();
+        headlessRenderer.reset();
     }
 
     //==============================================================================
@@ -125,6 +150,7 @@ public:
 
 private:
     std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<HeadlessRenderer> headlessRenderer;
 };
 
 //==============================================================================
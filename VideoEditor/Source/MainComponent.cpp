@@ -23,6 +23,7 @@
 */
 
 #include "MainComponent.h"
+#include "EditFile.h"
 #include "RenderDialog.h"
 
 namespace CommandIDs
@@ -39,17 +40,29 @@ namespace CommandIDs
         editPreferences = 200,
         editSplice,
         editVisibility,
+        editSpliceAll,
+        editRippleDelete,
+        editSelectAll,
 
         playStart = 300,
         playStop,
         playReturn,
         playRecord,
+        playShuttleBackward,
+        playShuttleForward,
+        playLoopIn,
+        playLoopOut,
+        playLoop,
 
         trackAdd = 400,
         trackRemove,
 
         viewFullScreen = 500,
         viewExitFullScreen,
+        viewProxies,
+        viewZoomIn,
+        viewZoomOut,
+        viewZoomToFit,
 
         helpAbout = 600,
         helpHelp
@@ -77,6 +90,15 @@ MainComponent::MainComponent()
     const auto area = Desktop::getInstance().getDisplays().getMainDisplay().userArea;
     setBounds (area);
 
+    preview.getPrefetcher().setSeekIndex (&seekIndex);
+
+    // the clip keeps playing from the original media, but the user should know why scrubbing stays slow
+    proxyManager.onProxyFailed = [] (const File& original, const String& error)
+    {
+        AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, NEEDS_TRANS ("Creating the proxy failed"),
+                                          "The proxy of \"" + original.getFullPathName() + "\" could not be created, the original media is used instead."
+                                          + (error.isNotEmpty() ? "\n\n" + error : String()));
+    };
     player.initialise();
     levelMeter.setMeterSource (&player.getMeterSource());
 
@@ -90,15 +112,23 @@ MainComponent::MainComponent()
 
     commandManager.getKeyMappings()->resetToDefaultMappings();
 
-    auto settingsFolder = juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory).getChildFile (ProjectInfo::companyName).getChildFile (ProjectInfo::projectName);
-    settingsFolder.createDirectory();
-    videoEngine.getAudioPluginManager().setPluginDataFile (settingsFolder.getChildFile ("PluginList.xml"));
+    videoEngine.getAudioPluginManager().setPluginDataFile (EditFile::getSettingsFolder().getChildFile ("PluginList.xml"));
 
     startTimerHz (10);
+
+    if (AutoSaver::getRecoveryFile().existsAsFile())
+        MessageManager::callAsync ([safeThis = SafePointer<MainComponent> (this)]
+        {
+            if (safeThis != nullptr)
+                safeThis->offerRecovery();
+        });
 }
 
 MainComponent::~MainComponent()
 {
+    // a regular quit leaves nothing to recover
+    autoSaver.clear();
+
     if (auto edit = timeline.getEditClip())
         edit->removeTimecodeListener (&preview);
 
@@ -140,6 +170,7 @@ void MainComponent::resized()
         levelMeter.setBounds (lower.removeFromRight (lower.getHeight() / 4).reduced (2));
         lower.removeFromTop (14); // TODO: ruler
         viewport.setBounds (lower);
+        timeline.updateSize();
         auto sides = bounds.getWidth() / 4.0;
         library.setBounds (bounds.removeFromLeft (sides));
         properties.setBounds (bounds.removeFromRight (sides));
@@ -156,6 +187,7 @@ void MainComponent::resetEdit()
     timeline.setEditClip (edit);
     edit->addTimecodeListener (&preview);
     editFileName = File();
+    autoSaver.setEdit (edit, editFileName);
     updateTitleBar();
 
     videoEngine.getUndoManager()->clearUndoHistory();
@@ -174,8 +206,9 @@ void MainComponent::loadEdit()
 
 void MainComponent::loadEditFile (const File& file)
 {
-    auto xml = XmlDocument::parse (file);
-    if (xml.get() == nullptr)
+    auto tree = EditFile::readTree (file);
+    auto edit = tree.isValid() ? EditFile::createEdit (videoEngine, proxyManager.withProxyMedia (tree)) : nullptr;
+    if (edit == nullptr)
     {
         AlertWindow::showMessageBox (AlertWindow::WarningIcon,
                                      NEEDS_TRANS ("Loading failed"),
@@ -184,22 +217,17 @@ void MainComponent::loadEditFile (const File& file)
     }
 
     editFileName = file;
-    auto tree = ValueTree::fromXml (*xml);
-    auto edit = std::make_shared<foleys::ComposedClip>(videoEngine);
-    videoEngine.manageLifeTime (edit);
-
-    for (auto clip : tree)
-        edit->getStatusTree().appendChild (clip.createCopy(), nullptr);
 
     timeline.setEditClip (edit);
     edit->addTimecodeListener (&preview);
+    autoSaver.setEdit (edit, editFileName);
 
     player.setPosition (0);
     updateTitleBar();
 
     videoEngine.getUndoManager()->clearUndoHistory();
 
-    timeline.resized();
+    timeline.updateSize();
 }
 
 void MainComponent::saveEdit (bool saveAs)
@@ -223,14 +251,12 @@ void MainComponent::saveEdit (bool saveAs)
 
     if (edit && editFileName.getFullPathName().isNotEmpty())
     {
-        FileOutputStream output (editFileName);
-        if (output.openedOk())
+        // the project always refers to the original media
+        edit->readPluginStatesIntoValueTree();
+        if (EditFile::writeTree (proxyManager.withOriginalMedia (edit->getStatusTree()), editFileName, EditFile::Format::compressed))
         {
-            edit->readPluginStatesIntoValueTree();
-
-            output.setPosition (0);
-            output.truncate();
-            output.writeString (edit->getStatusTree().toXmlString());
+            autoSaver.setEdit (edit, editFileName);
+            autoSaver.clear();
         }
         else
         {
@@ -240,19 +266,89 @@ void MainComponent::saveEdit (bool saveAs)
     }
 }
 
+void MainComponent::offerRecovery()
+{
+    auto recoveryFile = AutoSaver::getRecoveryFile();
+    if (! recoveryFile.existsAsFile())
+        return;
+
+    auto originalFile = AutoSaver::getOriginalFile (recoveryFile);
+    auto name = originalFile == File() ? String (NEEDS_TRANS ("an unsaved project")) : "\"" + originalFile.getFileNameWithoutExtension() + "\"";
+
+    auto recover = AlertWindow::showOkCancelBox (AlertWindow::QuestionIcon,
+                                                 NEEDS_TRANS ("Recover changes?"),
+                                                 "The VideoEditor was not closed properly. Do you want to recover the automatically saved copy of " + name + "?",
+                                                 NEEDS_TRANS ("Recover"), NEEDS_TRANS ("Discard"));
+    if (! recover)
+    {
+        recoveryFile.deleteFile();
+        return;
+    }
+
+    loadEditFile (recoveryFile);
+
+    // until the user saves, the recovery file is kept for the next crash
+    editFileName = originalFile;
+    autoSaver.setEdit (timeline.getEditClip(), editFileName);
+    updateTitleBar();
+}
+
 void MainComponent::showRenderDialog()
 {
+    // the output is rendered from the original media, not from the proxies
     if (! renderer.isRendering())
-        renderer.setClipToRender (timeline.getEditClip()->createCopy (foleys::StreamTypes::all()));
+    {
+        auto edit = timeline.getEditClip();
+        edit->readPluginStatesIntoValueTree();
+        renderer.setClipToRender (EditFile::createEdit (videoEngine, proxyManager.withOriginalMedia (edit->getStatusTree())));
+    }
 
     properties.showProperties (std::make_unique<RenderDialog>(renderer));
 }
 
+void MainComponent::setUseProxies (bool shouldUseProxies)
+{
+    proxyManager.setEnabled (shouldUseProxies);
+    commandManager.commandStatusChanged();
+
+    auto edit = timeline.getEditClip();
+    if (edit == nullptr)
+        return;
+
+    if (shouldUseProxies)
+        for (const auto& descriptor : edit->getClips())
+            if (descriptor->clip->hasVideo())
+                proxyManager.requestProxy (descriptor->clip->getMediaFile());
+
+    // Only the clips referring to other media are replaced, in the edit's own tree
+    // and through the UndoManager. So the edit recreates them from the other media,
+    // the undo history stays valid and the switch itself can be undone.
+    edit->readPluginStatesIntoValueTree();
+    auto status = edit->getStatusTree();
+    auto mapped = shouldUseProxies ? proxyManager.withProxyMedia (status)
+                                   : proxyManager.withOriginalMedia (status);
+
+    auto* undoManager = videoEngine.getUndoManager();
+    undoManager->beginNewTransaction (shouldUseProxies ? NEEDS_TRANS ("Use proxies") : NEEDS_TRANS ("Use original media"));
+
+    for (int i = 0; i < jmin (status.getNumChildren(), mapped.getNumChildren()); ++i)
+    {
+        if (status.getChild (i).isEquivalentTo (mapped.getChild (i)))
+            continue;
+
+        status.removeChild (i, undoManager);
+        status.addChild (mapped.getChild (i).createCopy(), i, undoManager);
+    }
+
+    undoManager->beginNewTransaction();
+
+    // the new clips start reading where the edit is
+    player.setPosition (player.getCurrentTimeInSeconds());
+}
+
 void MainComponent::deleteSelectedClip()
 {
-    if (auto selected = timeline.getSelectedClip())
-        if (auto edit = timeline.getEditClip())
-            edit->removeClip (selected);
+    timeline.deleteSelectedClips();
 }
 
 void MainComponent::showPreferences()
@@ -285,10 +381,14 @@ void MainComponent::getAllCommands (Array<CommandID>& commands)
     commands.add (CommandIDs::fileNew, CommandIDs::fileOpen, CommandIDs::fileSave, CommandIDs::fileSaveAs, CommandIDs::fileRender, StandardApplicationCommandIDs::quit);
     commands.add (StandardApplicationCommandIDs::undo, StandardApplicationCommandIDs::redo,
                   StandardApplicationCommandIDs::del, StandardApplicationCommandIDs::copy, StandardApplicationCommandIDs::paste,
-                  CommandIDs::editSplice, CommandIDs::editVisibility, CommandIDs::editPreferences);
-    commands.add (CommandIDs::playStart, CommandIDs::playStop, CommandIDs::playReturn);
+                  CommandIDs::editSplice, CommandIDs::editVisibility, CommandIDs::editPreferences,
+                  CommandIDs::editSpliceAll, CommandIDs::editRippleDelete, CommandIDs::editSelectAll);
+    commands.add (CommandIDs::playStart, CommandIDs::playStop, CommandIDs::playReturn,
+                  CommandIDs::playShuttleBackward, CommandIDs::playShuttleForward,
+                  CommandIDs::playLoopIn, CommandIDs::playLoopOut, CommandIDs::playLoop);
     commands.add (CommandIDs::trackAdd, CommandIDs::trackRemove);
-    commands.add (CommandIDs::viewFullScreen, CommandIDs::viewExitFullScreen);
+    commands.add (CommandIDs::viewFullScreen, CommandIDs::viewExitFullScreen, CommandIDs::viewProxies,
+                  CommandIDs::viewZoomIn, CommandIDs::viewZoomOut, CommandIDs::viewZoomToFit);
     commands.add (CommandIDs::helpAbout, CommandIDs::helpHelp);
 }
 
@@ -347,9 +447,21 @@ void MainComponent::getCommandInfo (CommandID commandID, ApplicationCommandInfo&
             result.defaultKeypresses.add (KeyPress ('v', ModifierKeys::commandModifier, 0));
             break;
         case CommandIDs::editSplice:
-            result.setInfo ("Splice", "Split selected clip at play position", categoryEdit, 0);
+            result.setInfo ("Splice", "Split the selected clips at play position", categoryEdit, 0);
             result.defaultKeypresses.add (KeyPress ('b', ModifierKeys::commandModifier, 0));
             break;
+        case CommandIDs::editSpliceAll:
+            result.setInfo ("Splice All", "Split the clips in all lanes at play position", categoryEdit, 0);
+            result.defaultKeypresses.add (KeyPress ('b', ModifierKeys::commandModifier | ModifierKeys::shiftModifier, 0));
+            break;
+        case CommandIDs::editRippleDelete:
+            result.setInfo ("Ripple Delete", "Delete the selected clips and close the gaps", categoryEdit, 0);
+            result.defaultKeypresses.add (KeyPress (KeyPress::backspaceKey, ModifierKeys::shiftModifier, 0));
+            break;
+        case CommandIDs::editSelectAll:
+            result.setInfo ("Select All", "Select all clips in the edit", categoryEdit, 0);
+            result.defaultKeypresses.add (KeyPress ('a', ModifierKeys::commandModifier, 0));
+            break;
         case CommandIDs::editVisibility:
             result.setInfo ("Visible", "Toggle visibility or mute of the selected clip", categoryEdit, 0);
             result.defaultKeypresses.add (KeyPress ('v', ModifierKeys::noModifiers, 0));
@@ -364,6 +476,28 @@ void MainComponent::getCommandInfo (CommandID commandID, ApplicationCommandInfo&
             break;
         case CommandIDs::playStop:
             result.setInfo ("Stop", "Stop playback", categoryPlay, 0);
+            result.defaultKeypresses.add (KeyPress ('k', ModifierKeys::noModifiers, 0));
+            break;
+        case CommandIDs::playShuttleBackward:
+            result.setInfo ("Shuttle Backward", "Play backwards, faster each time (hold K for quarter speed)", categoryPlay, 0);
+            result.defaultKeypresses.add (KeyPress ('j', ModifierKeys::noModifiers, 0));
+            break;
+        case CommandIDs::playShuttleForward:
+            result.setInfo ("Shuttle Forward", "Play forwards, faster each time (hold K for quarter speed)", categoryPlay, 0);
+            result.defaultKeypresses.add (KeyPress ('l', ModifierKeys::noModifiers, 0));
+            break;
+        case CommandIDs::playLoopIn:
+            result.setInfo ("Set Loop In", "Start the loop at the playhead", categoryPlay, 0);
+            result.defaultKeypresses.add (KeyPress ('i', ModifierKeys::noModifiers, 0));
+            break;
+        case CommandIDs::playLoopOut:
+            result.setInfo ("Set Loop Out", "End the loop at the playhead", categoryPlay, 0);
+            result.defaultKeypresses.add (KeyPress ('o', ModifierKeys::noModifiers, 0));
+            break;
+        case CommandIDs::playLoop:
+            result.setInfo ("Loop", "Play the range between loop in and out repeatedly", categoryPlay, 0);
+            result.setTicked (player.isLooping());
+            result.defaultKeypresses.add (KeyPress ('l', ModifierKeys::commandModifier, 0));
             break;
         case CommandIDs::playReturn:
             result.setInfo ("Return", "Set playhead to begin", categoryPlay, 0);
@@ -384,6 +518,22 @@ void MainComponent::getCommandInfo (CommandID commandID, ApplicationCommandInfo&
             result.setInfo ("Exit Fullscreen", "Normal viewer size", categoryView, 0);
             result.defaultKeypresses.add (KeyPress (KeyPress::escapeKey, ModifierKeys::noModifiers, 0));
             break;
+        case CommandIDs::viewProxies:
+            result.setInfo ("Proxy Media", "Preview low resolution proxies instead of the original media", categoryView, 0);
+            result.setTicked (proxyManager.isEnabled());
+            break;
+        case CommandIDs::viewZoomIn:
+            result.setInfo ("Zoom In", "Zoom into the timeline around the playhead", categoryView, 0);
+            result.defaultKeypresses.add (KeyPress ('+', ModifierKeys::commandModifier, 0));
+            break;
+        case CommandIDs::viewZoomOut:
+            result.setInfo ("Zoom Out", "Zoom out of the timeline around the playhead", categoryView, 0);
+            result.defaultKeypresses.add (KeyPress ('-', ModifierKeys::commandModifier, 0));
+            break;
+        case CommandIDs::viewZoomToFit:
+            result.setInfo ("Zoom to Fit", "Show the whole edit in the timeline", categoryView, 0);
+            result.defaultKeypresses.add (KeyPress ('0', ModifierKeys::commandModifier, 0));
+            break;
         case CommandIDs::helpAbout:
             result.setInfo ("About", "Show information about the program", categoryHelp, 0);
             break;
@@ -411,18 +561,30 @@ bool MainComponent::perform (const InvocationInfo& info)
         case StandardApplicationCommandIDs::del: deleteSelectedClip(); break;
         case CommandIDs::editSplice: timeline.spliceSelectedClipAtPlayPosition(); break;
         case CommandIDs::editVisibility: timeline.toggleVisibility(); break;
+        case CommandIDs::editSpliceAll: timeline.spliceAllClipsAtPlayPosition(); break;
+        case CommandIDs::editRippleDelete: timeline.rippleDeleteSelectedClips(); break;
+        case CommandIDs::editSelectAll: timeline.selectAllClips(); break;
 
         case CommandIDs::editPreferences: showPreferences(); break;
 
         case CommandIDs::playStart: if (player.isPlaying()) player.stop(); else player.start(); break;
         case CommandIDs::playStop: player.stop(); break;
         case CommandIDs::playReturn: player.setPosition (0.0) ; break;
+        case CommandIDs::playShuttleBackward: player.shuttleBackward (KeyPress::isKeyCurrentlyDown ('k')); break;
+        case CommandIDs::playShuttleForward: player.shuttleForward (KeyPress::isKeyCurrentlyDown ('k')); break;
+        case CommandIDs::playLoopIn: timeline.setLoopIn (player.getCurrentTimeInSeconds()); break;
+        case CommandIDs::playLoopOut: timeline.setLoopOut (player.getCurrentTimeInSeconds()); break;
+        case CommandIDs::playLoop: timeline.toggleLooping(); commandManager.commandStatusChanged(); break;
 
         case CommandIDs::trackAdd: break;
         case CommandIDs::trackRemove: break;
 
         case CommandIDs::viewFullScreen: setViewerFullScreen (! viewerFullScreen); break;
         case CommandIDs::viewExitFullScreen: setViewerFullScreen (false); break;
+        case CommandIDs::viewProxies: setUseProxies (! proxyManager.isEnabled()); break;
+        case CommandIDs::viewZoomIn: timeline.setZoom (timeline.getPixelsPerSecond() * 2.0, player.getCurrentTimeInSeconds()); break;
+        case CommandIDs::viewZoomOut: timeline.setZoom (timeline.getPixelsPerSecond() * 0.5, player.getCurrentTimeInSeconds()); break;
+        case CommandIDs::viewZoomToFit: timeline.zoomToFit(); break;
         default:
             jassertfalse;
             break;
@@ -459,10 +621,13 @@ PopupMenu MainComponent::getMenuForIndex (int topLevelMenuIndex,
         menu.addCommandItem (&commandManager, StandardApplicationCommandIDs::redo);
         menu.addSeparator();
         menu.addCommandItem (&commandManager, StandardApplicationCommandIDs::del);
+        menu.addCommandItem (&commandManager, CommandIDs::editRippleDelete);
         menu.addCommandItem (&commandManager, StandardApplicationCommandIDs::copy);
         menu.addCommandItem (&commandManager, StandardApplicationCommandIDs::paste);
         menu.addSeparator();
+        menu.addCommandItem (&commandManager, CommandIDs::editSelectAll);
         menu.addCommandItem (&commandManager, CommandIDs::editSplice);
+        menu.addCommandItem (&commandManager, CommandIDs::editSpliceAll);
         menu.addCommandItem (&commandManager, CommandIDs::editVisibility);
         menu.addSeparator();
         menu.addCommandItem (&commandManager, CommandIDs::editPreferences);
@@ -472,6 +637,13 @@ PopupMenu MainComponent::getMenuForIndex (int topLevelMenuIndex,
         menu.addCommandItem (&commandManager, CommandIDs::playStart);
         menu.addCommandItem (&commandManager, CommandIDs::playStop);
         menu.addCommandItem (&commandManager, CommandIDs::playReturn);
+        menu.addSeparator();
+        menu.addCommandItem (&commandManager, CommandIDs::playShuttleBackward);
+        menu.addCommandItem (&commandManager, CommandIDs::playShuttleForward);
+        menu.addSeparator();
+        menu.addCommandItem (&commandManager, CommandIDs::playLoopIn);
+        menu.addCommandItem (&commandManager, CommandIDs::playLoopOut);
+        menu.addCommandItem (&commandManager, CommandIDs::playLoop);
     }
     else if (topLevelMenuIndex == 3)
     {
@@ -482,6 +654,12 @@ PopupMenu MainComponent::getMenuForIndex (int topLevelMenuIndex,
     {
         menu.addCommandItem (&commandManager, CommandIDs::viewFullScreen);
         menu.addCommandItem (&commandManager, CommandIDs::viewExitFullScreen);
+        menu.addSeparator();
+        menu.addCommandItem (&commandManager, CommandIDs::viewZoomIn);
+        menu.addCommandItem (&commandManager, CommandIDs::viewZoomOut);
+        menu.addCommandItem (&commandManager, CommandIDs::viewZoomToFit);
+        menu.addSeparator();
+        menu.addCommandItem (&commandManager, CommandIDs::viewProxies);
     }
     else if (topLevelMenuIndex == 5)
     {
@@ -498,4 +676,5 @@ void MainComponent::timerCallback()
             return;
 
     videoEngine.getUndoManager()->beginNewTransaction();
+    autoSaver.saveIfNeeded();
 }
@@ -26,9 +26,15 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 
+#include "AutoSaver.h"
+#include "PeakCache.h"
 #include "Player.h"
 #include "Library.h"
 #include "Properties.h"
+#include "ProxyManager.h"
+#include "SeekIndex.h"
+#include "SegmentRenderer.h"
+#include "ThumbnailCache.h"
 #include "TimeLine.h"
 #include "TransportControl.h"
 
@@ -76,7 +82,9 @@ private:
     void resetEdit();
     void loadEdit();
     void saveEdit (bool saveAs);
+    void offerRecovery();
     void showRenderDialog();
+    void setUseProxies (bool shouldUseProxies);
 
     void deleteSelectedClip();
     void showPreferences();
@@ -87,19 +95,24 @@ private:
 
     AudioDeviceManager    deviceManager;
     foleys::VideoEngine   videoEngine;
-    foleys::ClipRenderer  renderer { videoEngine };
+    SegmentRenderer       renderer { videoEngine };
 
     ApplicationCommandManager   commandManager;
 
-    foleys::VideoPreview  preview;
+    SeekIndex             seekIndex;
+    PrefetchedPreview     preview { videoEngine };
     Player                player  { deviceManager, videoEngine, preview };
 
     Library               library    { player, videoEngine };
     Properties            properties;
     Viewport              viewport;
-    TimeLine              timeline   { videoEngine, player, properties };
+    ThumbnailCache        thumbnailCache;
+    PeakCache             peakCache  { videoEngine.getAudioFormatManager() };
+    ProxyManager          proxyManager;
+    TimeLine              timeline   { videoEngine, player, properties, thumbnailCache, peakCache, proxyManager };
     TransportControl      transport  { player };
     foleys::LevelMeter    levelMeter { std::make_unique<foleys::VerticalMultiChannelMeter>() };
+    AutoSaver             autoSaver;
 
     File editFileName;
     int  lowerPart = 0;
@@ -0,0 +1,355 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    PeakCache.cpp
+    Created: 17 Oct 2026 8:45:39pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+#include "PeakCache.h"
+
+namespace
+{
+    // "VPKS" when read as little endian int
+    constexpr int peakFileMagic   = 0x534b5056;
+    constexpr int peakFileVersion = 1;
+
+    int16 toInt16 (float value)
+    {
+        return int16 (jlimit (-32767, 32767, roundToInt (value * 32767.0f)));
+    }
+
+    float fromInt16 (int16 value)
+    {
+        return value / 32767.0f;
+    }
+}
+
+//==============================================================================
+
+PeakFile::PeakFile (const File& file)
+  : mapped (file, MemoryMappedFile::readOnly)
+{
+    if (mapped.getData() == nullptr)
+        return;
+
+    MemoryInputStream header (mapped.getData(), mapped.getSize(), false);
+    if (header.readInt() != peakFileMagic || header.readInt() != peakFileVersion)
+        return;
+
+    const auto rate     = header.readDouble();
+    const auto channels = header.readInt();
+    const auto levels   = header.readInt();
+    const auto samples  = header.readInt64();
+
+    if (rate <= 0.0 || channels <= 0 || ! isPositiveAndNotGreaterThan (levels, maxLevels))
+        return;
+
+    std::vector<int64> sizes;
+    for (int level = 0; level < levels; ++level)
+        sizes.push_back (header.readInt64());
+
+    auto offset = size_t (header.getPosition());
+    std::vector<const int16*> data;
+
+    for (auto size : sizes)
+    {
+        const auto bytes = size_t (size) * size_t (channels) * 3 * sizeof (int16);
+        if (size < 0 || offset + bytes > mapped.getSize())
+            return;
+
+        data.push_back (static_cast<const int16*> (addBytesToPointer (mapped.getData(), offset)));
+        offset += bytes;
+    }
+
+    sampleRate  = rate;
+    numChannels = channels;
+    numSamples  = samples;
+    levelSizes  = std::move (sizes);
+    levelData   = std::move (data);
+}
+
+bool PeakFile::isValid() const
+{
+    return ! levelData.empty();
+}
+
+double PeakFile::getLengthInSeconds() const
+{
+    return sampleRate > 0.0 ? numSamples / sampleRate : 0.0;
+}
+
+const int16* PeakFile::getEntry (int level, int64 index, int channel) const
+{
+    return levelData [size_t (level)] + (index * numChannels + channel) * 3;
+}
+
+void PeakFile::getPeaks (int channel, double start, double end, std::vector<Peak>& peaks) const
+{
+    std::fill (peaks.begin(), peaks.end(), Peak());
+
+    if (! isValid() || peaks.empty() || ! isPositiveAndBelow (channel, numChannels) || end <= start)
+        return;
+
+    const auto numPixels = double (peaks.size());
+    const auto samplesPerPixel = (end - start) * sampleRate / numPixels;
+
+    // the coarsest level that still has at least one entry per pixel
+    int    level = 0;
+    double decimation = baseDecimation;
+    while (level + 1 < int (levelSizes.size()) && decimation * levelFactor <= samplesPerPixel)
+    {
+        ++level;
+        decimation *= levelFactor;
+    }
+
+    const auto size = levelSizes [size_t (level)];
+
+    for (size_t pixel = 0; pixel < peaks.size(); ++pixel)
+    {
+        const auto first = int64 ((start * sampleRate + pixel * samplesPerPixel) / decimation);
+        const auto last  = jmax (first + 1, int64 (std::ceil ((start * sampleRate + (pixel + 1) * samplesPerPixel) / decimation)));
+
+        if (first >= size)
+            break;
+
+        if (first < 0)
+            continue;
+
+        auto& peak = peaks [pixel];
+        peak.min = 1.0f;
+        peak.max = -1.0f;
+        auto sumSquares = 0.0f;
+
+        const auto stop = jmin (last, size);
+        for (auto index = first; index < stop; ++index)
+        {
+            const auto* entry = getEntry (level, index, channel);
+            peak.min = jmin (peak.min, fromInt16 (entry [0]));
+            peak.max = jmax (peak.max, fromInt16 (entry [1]));
+            sumSquares += square (fromInt16 (entry [2]));
+        }
+
+        peak.rms = std::sqrt (sumSquares / (stop - first));
+    }
+}
+
+bool PeakFile::build (AudioFormatReader& reader, const File& file, std::function<bool()> shouldExit)
+{
+    const auto channels = jmax (1, int (reader.numChannels));
+
+    std::vector<std::vector<int16>> levels (1);
+    levels.front().reserve (size_t (reader.lengthInSamples / baseDecimation + 1) * size_t (channels) * 3);
+
+    AudioBuffer<float> buffer (channels, baseDecimation * 64);
+
+    for (int64 position = 0; position < reader.lengthInSamples; position += buffer.getNumSamples())
+    {
+        if (shouldExit && shouldExit())
+            return false;
+
+        const auto numSamples = int (jmin (int64 (buffer.getNumSamples()), reader.lengthInSamples - position));
+        reader.read (&buffer, 0, numSamples, position, true, true);
+
+        for (int block = 0; block < numSamples; block += baseDecimation)
+        {
+            const auto blockSize = jmin (baseDecimation, numSamples - block);
+
+            for (int channel = 0; channel < channels; ++channel)
+            {
+                const auto range = FloatVectorOperations::findMinAndMax (buffer.getReadPointer (channel, block), blockSize);
+                const auto rms   = buffer.getRMSLevel (channel, block, blockSize);
+
+                levels.front().push_back (toInt16 (range.getStart()));
+                levels.front().push_back (toInt16 (range.getEnd()));
+                levels.front().push_back (toInt16 (rms));
+            }
+        }
+    }
+
+    // each level combines levelFactor entries of the level below
+    while (int (levels.size()) < maxLevels && levels.back().size() > size_t (channels * 3))
+    {
+        const auto& source = levels.back();
+        const auto numEntries = source.size() / size_t (channels * 3);
+
+        std::vector<int16> level;
+        level.reserve ((numEntries / levelFactor + 1) * size_t (channels) * 3);
+
+        for (size_t first = 0; first < numEntries; first += levelFactor)
+        {
+            const auto last = std::min (first + levelFactor, numEntries);
+
+            for (int channel = 0; channel < channels; ++channel)
+            {
+                int16 min = 32767, max = -32767;
+                auto sumSquares = 0.0f;
+
+                for (auto index = first; index < last; ++index)
+                {
+                    const auto* entry = &source [(index * size_t (channels) + size_t (channel)) * 3];
+                    min = std::min (min, entry [0]);
+                    max = std::max (max, entry [1]);
+                    sumSquares += square (fromInt16 (entry [2]));
+                }
+
+                level.push_back (min);
+                level.push_back (max);
+                level.push_back (toInt16 (std::sqrt (sumSquares / (last - first))));
+            }
+        }
+
+        levels.push_back (std::move (level));
+    }
+
+    TemporaryFile temp (file);
+    {
+        FileOutputStream output (temp.getFile());
+        if (! output.openedOk())
+            return false;
+
+        output.writeInt (peakFileMagic);
+        output.writeInt (peakFileVersion);
+        output.writeDouble (reader.sampleRate);
+        output.writeInt (channels);
+        output.writeInt (int (levels.size()));
+        output.writeInt64 (reader.lengthInSamples);
+
+        for (const auto& level : levels)
+            output.writeInt64 (int64 (level.size() / size_t (channels * 3)));
+
+        // the entries are mapped as they are, so they are written in the native byte order
+        for (const auto& level : levels)
+            output.write (level.data(), level.size() * sizeof (int16));
+
+        output.flush();
+        if (output.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+
+class PeakCache::BuildJob  : public ThreadPoolJob
+{
+public:
+    BuildJob (PeakCache& ownerToUse, const File& sourceToUse, const File& targetToUse)
+      : ThreadPoolJob ("Peaks"),
+        owner (ownerToUse),
+        source (sourceToUse),
+        target (targetToUse)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto success = false;
+        if (auto reader = std::unique_ptr<AudioFormatReader> (owner.formatManager.createReaderFor (source)))
+            success = PeakFile::build (*reader, target, [this] { return shouldExit(); });
+
+        auto peaks = success ? std::make_shared<PeakFile>(target) : nullptr;
+
+        {
+            const ScopedLock sl (owner.lock);
+            owner.building.erase (target.getFullPathName());
+            if (peaks != nullptr && peaks->isValid())
+                owner.peakFiles [target.getFullPathName()] = peaks;
+            else if (! shouldExit())
+                owner.failed.insert (target.getFullPathName());
+        }
+
+        owner.sendChangeMessage();
+        return jobHasFinished;
+    }
+
+private:
+    PeakCache& owner;
+    File source;
+    File target;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BuildJob)
+};
+
+//==============================================================================
+
+PeakCache::PeakCache (AudioFormatManager& formatManagerToUse)
+  : formatManager (formatManagerToUse),
+    folder (EditFile::getSettingsFolder().getChildFile ("Peaks"))
+{
+    folder.createDirectory();
+}
+
+PeakCache::~PeakCache()
+{
+    threadPool.removeAllJobs (true, 5000);
+}
+
+bool PeakCache::canBuild (const URL& media) const
+{
+    if (! media.isLocalFile() || formatManager.findFormatForFileExtension (media.getLocalFile().getFileExtension()) == nullptr)
+        return false;
+
+    const ScopedLock sl (lock);
+    return failed.count (getPeakFileName (media).getFullPathName()) == 0;
+}
+
+File PeakCache::getPeakFileName (const URL& media) const
+{
+    const auto source = media.getLocalFile();
+    const auto id = source.getFullPathName() + "@" + String (source.getLastModificationTime().toMilliseconds());
+    return folder.getChildFile (String::toHexString (id.hashCode64()) + ".peaks");
+}
+
+std::shared_ptr<PeakFile> PeakCache::getPeakFile (const URL& media)
+{
+    if (! canBuild (media))
+        return {};
+
+    const auto file = getPeakFileName (media);
+    const auto key  = file.getFullPathName();
+
+    const ScopedLock sl (lock);
+
+    auto it = peakFiles.find (key);
+    if (it != peakFiles.end())
+        return it->second;
+
+    if (building.count (key) > 0 || failed.count (key) > 0)
+        return {};
+
+    if (file.existsAsFile())
+    {
+        auto peaks = std::make_shared<PeakFile>(file);
+        if (peaks->isValid())
+        {
+            peakFiles [key] = peaks;
+            return peaks;
+        }
+    }
+
+    building.insert (key);
+    threadPool.addJob (new BuildJob (*this, media.getLocalFile(), file), true);
+    return {};
+}
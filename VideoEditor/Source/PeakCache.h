@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    PeakCache.h
+    Created: 17 Oct 2026 8:45:39pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    A precomputed waveform overview of a media file: min, max and RMS of each
+    channel at several decimation levels, each level four times coarser than
+    the one before. The file is memory mapped, drawing reads only the entries
+    of the level closest to the pixel resolution.
+*/
+class PeakFile
+{
+public:
+    struct Peak
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float rms = 0.0f;
+    };
+
+    /** Maps the file, check isValid() afterwards */
+    PeakFile (const File& file);
+
+    bool isValid() const;
+
+    int    getNumChannels() const   { return numChannels; }
+    double getSampleRate() const    { return sampleRate; }
+    double getLengthInSeconds() const;
+
+    /** Fills one Peak per element of peaks for the channel between start and end in seconds */
+    void getPeaks (int channel, double start, double end, std::vector<Peak>& peaks) const;
+
+    /** Reads the whole source and writes the peak file. Returns false if it was aborted or failed. */
+    static bool build (AudioFormatReader& reader, const File& file, std::function<bool()> shouldExit);
+
+    static constexpr int baseDecimation = 256;
+    static constexpr int levelFactor    = 4;
+    static constexpr int maxLevels      = 8;
+
+private:
+
+    const int16* getEntry (int level, int64 index, int channel) const;
+
+    MemoryMappedFile mapped;
+
+    double sampleRate  = 0.0;
+    int    numChannels = 0;
+    int64  numSamples  = 0;
+    std::vector<int64>        levelSizes;
+    std::vector<const int16*> levelData;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PeakFile)
+};
+
+//==============================================================================
+/*
+    Builds the PeakFiles in the background and keeps them in the settings
+    folder. Listeners are notified when a build finished.
+*/
+class PeakCache  : public ChangeBroadcaster
+{
+public:
+    PeakCache (AudioFormatManager& formatManager);
+    ~PeakCache();
+
+    /** Returns the peaks of the media, or nullptr if they are not ready. Starts building them if necessary. */
+    std::shared_ptr<PeakFile> getPeakFile (const URL& media);
+
+    /** Returns true if the media can be read to build peaks, and building didn't fail before */
+    bool canBuild (const URL& media) const;
+
+private:
+
+    class BuildJob;
+
+    File getPeakFileName (const URL& media) const;
+
+    AudioFormatManager& formatManager;
+    File folder;
+
+    CriticalSection lock;
+    std::map<String, std::shared_ptr<PeakFile>> peakFiles;
+    std::set<String> building;
+    std::set<String> failed;
+
+    ThreadPool threadPool { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PeakCache)
+};
@@ -25,34 +25,88 @@
 */
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
 #include "Player.h"
 
 //==============================================================================
 Player::Player (AudioDeviceManager& deviceManagerToUse,
                 foleys::VideoEngine& engine,
-                foleys::VideoPreview& previewToUse)
+                PrefetchedPreview& previewToUse)
   : deviceManager (deviceManagerToUse),
     videoEngine (engine),
     preview (previewToUse)
 {
 }
 
+namespace
+{
+    /*
+        Measures peak and sum of squares of one channel and clips it in the same
+        pass. The four independent lanes allow the compiler to vectorise the loop.
+    */
+    template<bool clipOutput>
+    void measureAndClip (float* data, int numSamples, float& peak, float& sumOfSquares)
+    {
+        float lanePeak[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float laneSum[4]  = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                const auto sample = data [i + lane];
+                lanePeak [lane] = jmax (lanePeak [lane], std::abs (sample));
+                laneSum  [lane] += sample * sample;
+
+                if (clipOutput)
+                    data [i + lane] = jlimit (-1.0f, 1.0f, sample);
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            const auto sample = data [i];
+            lanePeak [0] = jmax (lanePeak [0], std::abs (sample));
+            laneSum  [0] += sample * sample;
+
+            if (clipOutput)
+                data [i] = jlimit (-1.0f, 1.0f, sample);
+        }
+
+        peak = jmax (lanePeak [0], lanePeak [1], lanePeak [2], lanePeak [3]);
+        sumOfSquares = laneSum [0] + laneSum [1] + laneSum [2] + laneSum [3];
+    }
+
+    void updateLoad (std::atomic<float>& load, double seconds, double budget)
+    {
+        if (budget > 0.0)
+            load.store (float (0.8 * load.load() + 0.2 * seconds / budget));
+    }
+}
+
 Player::~Player()
 {
+    statusTree.removeListener (this);
     shutDown();
 }
 
 void Player::start()
 {
-    stopAudition();
+    // starting outside the loop plays the loop
+    if (looping && ! loopRange.isEmpty() && ! loopRange.contains (getCurrentTimeInSeconds()))
+        setPosition (loopRange.getStart());
 
-    transportSource.start();
-    sendChangeMessage();
+    setShuttleSpeed (1.0);
 }
 
 void Player::stop()
 {
     transportSource.stop();
+    stopShuttleReader();
+
+    shuttleSpeed = 1.0;
+    shuttleSource.setSpeed (1.0);
     sendChangeMessage();
 }
 
@@ -66,39 +120,453 @@ void Player::setPosition (double pts)
     if (isAuditioning())
         stopAudition();
 
-    if (clip)
+    if (preparing)
+        pendingPosition = pts;
+    else if (clip)
         clip->setNextReadPosition (pts * getSampleRate());
 
+    loopSource.cancelSeekRequest();
+
+    shuttlePosition = pts;
+    shuttleTarget   = -1.0;
+
+    if (transportSource.isPlaying() && isJumping())
+        startShuttleReader();
+
+    preview.setPosition (pts);
+    sendChangeMessage();
+}
+
+void Player::setShuttleSpeed (double speed)
+{
+    speed = jlimit (-ShuttleSource::maxSpeed, ShuttleSource::maxSpeed, speed);
+    if (speed == 0.0)
+    {
+        stop();
+        return;
+    }
+
+    // while jumping the clip may sit on a keyframe, so the shuttle position is kept
+    const auto wasJumping   = transportSource.isPlaying() && isJumping();
+    const auto wasBackwards = shuttleSpeed < 0.0;
+
+    shuttleSpeed = speed;
+
+    if (! wasJumping)
+        shuttlePosition = getCurrentTimeInSeconds();
+
+    if (isJumping())
+    {
+        // the reader keeps its direction, the speed only changes the resampling
+        if (! wasJumping || wasBackwards != (speed < 0.0) || shuttleReader == nullptr)
+            startShuttleReader();
+    }
+    else
+    {
+        stopShuttleReader();
+
+        // the clip continues where the shuttle is, not on the last keyframe
+        if (wasJumping && clip != nullptr && ! preparing)
+        {
+            clip->setNextReadPosition (int64 (shuttlePosition * getSampleRate()));
+            loopSource.cancelSeekRequest();
+            preview.setPosition (shuttlePosition);
+        }
+    }
+
+    shuttleSource.setSpeed (speed);
+
+    shuttleTarget   = -1.0;
+    lastShuttleTick = Time::getMillisecondCounterHiRes();
+
+    if (! transportSource.isPlaying())
+    {
+        stopAudition();
+        transportSource.start();
+    }
+
+    sendChangeMessage();
+}
+
+double Player::getShuttleSpeed() const
+{
+    return transportSource.isPlaying() ? shuttleSpeed : 0.0;
+}
+
+void Player::shuttleForward (bool slow)
+{
+    const auto speed = getShuttleSpeed();
+
+    if (slow)
+        setShuttleSpeed (0.25);
+    else if (speed <= 0.0)
+        setShuttleSpeed (1.0);
+    else
+        setShuttleSpeed (speed < 1.0 ? speed * 2.0 : jmin (speed * 2.0, ShuttleSource::maxSpeed));
+}
+
+void Player::shuttleBackward (bool slow)
+{
+    const auto speed = getShuttleSpeed();
+
+    if (slow)
+        setShuttleSpeed (-0.25);
+    else if (speed >= 0.0)
+        setShuttleSpeed (-1.0);
+    else
+        setShuttleSpeed (jmax (speed * 2.0, -ShuttleSource::maxSpeed));
+}
+
+void Player::setLoopRange (Range<double> range)
+{
+    loopRange = range.getStart() < 0.0 ? Range<double>() : range;
+    updateLoop();
+    sendChangeMessage();
+}
+
+Range<double> Player::getLoopRange() const
+{
+    return loopRange;
+}
+
+void Player::setLooping (bool shouldLoop)
+{
+    looping = shouldLoop;
+    updateLoop();
     sendChangeMessage();
 }
 
+bool Player::isLooping() const
+{
+    return looping;
+}
+
+void Player::updateLoop()
+{
+    const auto sampleRate = getSampleRate();
+    const auto active = looping && ! loopRange.isEmpty() && sampleRate > 0.0;
+
+    loopSource.setLoopRange (active ? Range<int64> (int64 (loopRange.getStart() * sampleRate), int64 (loopRange.getEnd() * sampleRate))
+                                    : Range<int64>());
+
+    preview.getPrefetcher().setPreroll (active ? loopRange.getStart() : -1.0);
+
+    // switching the loop off while a wraparound waits for its seek plays on from the loop end
+    if (! active)
+        loopSource.cancelSeekRequest();
+
+    // the loop start is rendered right away, edits are waited for in invalidatePreroll()
+    prerollStale = true;
+    prerollDue   = Time::getMillisecondCounter();
+}
+
+void Player::invalidatePreroll()
+{
+    if (! looping)
+        return;
+
+    prerollStale = true;
+    prerollDue   = Time::getMillisecondCounter() + 300;
+}
+
+void Player::renderPreroll()
+{
+    prerollStale = false;
+    const auto generation = ++prerollGeneration;
+
+    // the audio of the previous edit or loop start must not be heard
+    if (preroll != nullptr)
+    {
+        releasedPrerolls.push_back (preroll);
+        preroll.reset();
+        loopSource.setPreroll (nullptr);
+    }
+
+    auto* device = deviceManager.getCurrentAudioDevice();
+    if (! looping || loopRange.isEmpty() || clip == nullptr || device == nullptr)
+        return;
+
+    auto createCopy = getCopyFunction();
+
+    const auto sampleRate  = device->getCurrentSampleRate();
+    const auto start       = int64 (loopRange.getStart() * sampleRate);
+    const auto length      = int (jmin (loopRange.getLength(), prerollSeconds) * sampleRate);
+    const auto numChannels = jmax (1, device->getActiveOutputChannels().countNumberOfSetBits());
+
+    videoEngine.getThreadPool().addJob ([self = WeakReference<Player> (this), createCopy, generation, start, length, numChannels,
+                                         blockSize = device->getDefaultBufferSize(), sampleRate]
+    {
+        auto copy = createCopy();
+        if (copy == nullptr)
+            return ThreadPoolJob::jobHasFinished;
+
+        auto rendered = std::make_shared<LoopSource::Preroll>();
+        rendered->start = start;
+        rendered->buffer.setSize (numChannels, length);
+        rendered->buffer.clear();
+
+        // the copy is read like the renderer reads an edit, waiting for the decoders
+        copy->prepareToPlay (blockSize, sampleRate);
+        copy->setNextReadPosition (start);
+
+        for (int done = 0; done < length; done += blockSize)
+        {
+            const auto numSamples = jmin (blockSize, length - done);
+            copy->waitForSamplesReady (numSamples, 1000);
+            copy->getNextAudioBlock (AudioSourceChannelInfo (&rendered->buffer, done, numSamples));
+        }
+
+        MessageManager::callAsync ([self, rendered, generation]
+        {
+            if (self != nullptr && self->prerollGeneration == generation)
+            {
+                self->preroll = rendered;
+                self->loopSource.setPreroll (rendered.get());
+            }
+        });
+
+        return ThreadPoolJob::jobHasFinished;
+    });
+}
+
+std::function<std::shared_ptr<foleys::AVClip>()> Player::getCopyFunction() const
+{
+    // only the tree is copied here, the job opens the media of its copy itself
+    if (auto composed = std::dynamic_pointer_cast<foleys::ComposedClip> (clip))
+        return [&engine = videoEngine, tree = composed->getStatusTree().createCopy()]
+        {
+            return std::shared_ptr<foleys::AVClip> (EditFile::createEdit (engine, tree));
+        };
+
+    return [source = clip] { return source->createCopy (foleys::StreamTypes::audio()); };
+}
+
+bool Player::isJumping() const
+{
+    return shuttleSpeed < 0.0 || shuttleSpeed > ShuttleSource::maxInputSpeed;
+}
+
+void Player::startShuttleReader()
+{
+    stopShuttleReader();
+
+    auto* device = deviceManager.getCurrentAudioDevice();
+    if (clip == nullptr || device == nullptr)
+        return;
+
+    const auto sampleRate  = device->getCurrentSampleRate();
+    const auto numChannels = jmax (1, device->getActiveOutputChannels().countNumberOfSetBits());
+
+    // two seconds are enough to read ahead of the fastest speed
+    shuttleReader = std::make_shared<ShuttleReader> (numChannels, int (2.0 * sampleRate));
+    shuttleSource.setReader (shuttleReader.get());
+
+    videoEngine.getThreadPool().addJob ([reader = shuttleReader, createCopy = getCopyFunction(), numChannels, sampleRate,
+                                         blockSize  = device->getDefaultBufferSize(),
+                                         chunkSize  = int (shuttleChunkSeconds * sampleRate),
+                                         start      = int64 (shuttlePosition * sampleRate),
+                                         backwards  = shuttleSpeed < 0.0]
+    {
+        auto copy = createCopy();
+        if (copy == nullptr)
+            return ThreadPoolJob::jobHasFinished;
+
+        copy->prepareToPlay (blockSize, sampleRate);
+
+        AudioBuffer<float> chunk (numChannels, chunkSize);
+        auto position = jlimit (int64 (0), copy->getTotalLength(), start);
+
+        if (! backwards)
+            copy->setNextReadPosition (position);
+
+        while (! reader->isStopped())
+        {
+            const auto available  = backwards ? position : copy->getTotalLength() - position;
+            const auto numSamples = int (jmin (int64 (chunkSize), available));
+            if (numSamples <= 0)
+                break;
+
+            // backwards each chunk is read forward from its start and reversed
+            if (backwards)
+                copy->setNextReadPosition (position - numSamples);
+
+            chunk.clear();
+
+            for (int done = 0; done < numSamples; done += blockSize)
+            {
+                const auto numBlock = jmin (blockSize, numSamples - done);
+                copy->waitForSamplesReady (numBlock, 1000);
+                copy->getNextAudioBlock (AudioSourceChannelInfo (&chunk, done, numBlock));
+            }
+
+            if (backwards)
+                chunk.reverse (0, numSamples);
+
+            position += backwards ? -numSamples : numSamples;
+
+            if (! reader->write (chunk, numSamples))
+                break;
+        }
+
+        return ThreadPoolJob::jobHasFinished;
+    });
+}
+
+void Player::stopShuttleReader()
+{
+    if (shuttleReader == nullptr)
+        return;
+
+    // the job holds the reader itself, the audio thread is only done with it once idle
+    shuttleReader->stop();
+    shuttleSource.setReader (nullptr);
+    releasedReaders.push_back (shuttleReader);
+    shuttleReader.reset();
+}
+
+void Player::updateShuttle()
+{
+    const auto now = Time::getMillisecondCounterHiRes();
+    const auto elapsed = (now - lastShuttleTick) / 1000.0;
+    lastShuttleTick = now;
+
+    if (! transportSource.isPlaying() || ! isJumping() || clip == nullptr || preparing)
+        return;
+
+    const auto length = clip->getLengthInSeconds();
+    shuttlePosition = jlimit (0.0, length, shuttlePosition + shuttleSpeed * elapsed);
+
+    // The audio comes from the shuttle reader, the clip is only moved for the
+    // picture. Fast enough, only keyframes are shown: they decode without the
+    // frames in between.
+    auto target = shuttlePosition;
+    if (shuttleSpeed > ShuttleSource::maxInputSpeed || shuttleSpeed < -ShuttleSource::maxInputSpeed)
+        target = preview.getPrefetcher().getKeyframeBefore (shuttlePosition);
+
+    if (target != shuttleTarget)
+    {
+        shuttleTarget = target;
+        clip->setNextReadPosition (int64 (target * getSampleRate()));
+        loopSource.cancelSeekRequest();
+        preview.setPosition (target);
+        sendChangeMessage();
+    }
+
+    if ((shuttleSpeed < 0.0 && shuttlePosition <= 0.0) || (shuttleSpeed > 0.0 && shuttlePosition >= length))
+        stop();
+}
+
 double Player::getCurrentTimeInSeconds() const
 {
+    if (preparing)
+        return pendingPosition;
+
     if (clip)
         return clip->getCurrentTimeInSeconds();
 
     return {};
 }
 
-void Player::setClip (std::shared_ptr<foleys::AVClip> clipToUse, bool needsPrepare)
+void Player::setClip (std::shared_ptr<foleys::AVClip> clipToUse, bool needsPrepare, std::function<void()> onReady)
 {
-    auto numChannels = 2;
-    transportSource.stop();
-    transportSource.setSource (nullptr);
-    clip = clipToUse;
-    if (needsPrepare && clip != nullptr)
+    onClipReady = std::move (onReady);
+    auto* device = deviceManager.getCurrentAudioDevice();
+
+    // The clip playing or still fading out was prepared already, and the audio
+    // thread reads it, so it can't be prepared again concurrently.
+    const auto wasPlayed = clipToUse == clip
+                        || std::find (releasePool.begin(), releasePool.end(), clipToUse) != releasePool.end();
+
+    if (! needsPrepare || clipToUse == nullptr || wasPlayed || device == nullptr)
+    {
+        pendingClip.reset();
+        swapClip (clipToUse);
+        return;
+    }
+
+    // preparing can take a while, the current clip keeps playing until then
+    if (! preparing)
+        pendingPosition = 0.0;
+
+    preparing   = true;
+    pendingClip = clipToUse;
+
+    // a job still preparing this clip swaps it in when it is done
+    if (std::find (clipsInPreparation.begin(), clipsInPreparation.end(), clipToUse) != clipsInPreparation.end())
+        return;
+
+    clipsInPreparation.push_back (clipToUse);
+
+    videoEngine.getThreadPool().addJob ([self = WeakReference<Player> (this), clipToUse,
+                                         blockSize = device->getDefaultBufferSize(),
+                                         sampleRate = device->getCurrentSampleRate()]
     {
-        if (auto* device = deviceManager.getCurrentAudioDevice())
+        clipToUse->prepareToPlay (blockSize, sampleRate);
+
+        MessageManager::callAsync ([self, clipToUse]
         {
-            clip->prepareToPlay (device->getDefaultBufferSize(), device->getCurrentSampleRate());
-            numChannels = device->getOutputChannelNames().size();
-        }
+            if (self == nullptr)
+                return;
+
+            auto& inPreparation = self->clipsInPreparation;
+            inPreparation.erase (std::remove (inPreparation.begin(), inPreparation.end(), clipToUse), inPreparation.end());
+
+            if (self->pendingClip == clipToUse)
+            {
+                self->pendingClip.reset();
+                self->swapClip (clipToUse);
+            }
+        });
+
+        return ThreadPoolJob::jobHasFinished;
+    });
+}
+
+void Player::swapClip (std::shared_ptr<foleys::AVClip> newClip)
+{
+    if (clip != nullptr)
+        releasePool.push_back (clip);
+
+    clip = newClip;
+
+    statusTree.removeListener (this);
+    statusTree = {};
+
+    if (auto composed = std::dynamic_pointer_cast<foleys::ComposedClip> (clip))
+    {
+        statusTree = composed->getStatusTree();
+        statusTree.addListener (this);
     }
 
-    transportSource.setSource (clip.get());
+    const auto wasPreparing = preparing;
+    if (wasPreparing && clip != nullptr)
+        clip->setNextReadPosition (pendingPosition * getSampleRate());
+
+    preparing = false;
+    clipSource.setNextSource (clip.get());
+    loopSource.cancelSeekRequest();
+
+    auto numChannels = 2;
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+        numChannels = device->getOutputChannelNames().size();
+
     transportSource.meterSource.resize (numChannels, 5);
 
     preview.setClip (clip);
+    if (wasPreparing)
+        preview.setPosition (pendingPosition);
+
+    updateLoop();
+
+    // the reader reads a copy of the previous clip
+    if (transportSource.isPlaying() && isJumping())
+        startShuttleReader();
+
+    auto callback = std::move (onClipReady);
+    onClipReady = nullptr;
+
+    if (callback)
+        callback();
 
     sendChangeMessage();
 }
@@ -141,6 +609,8 @@ bool Player::isAuditioning() const
 
 void Player::initialise ()
 {
+    startTimerHz (30);
+
     deviceManager.initialise (0, 2, nullptr, true);
     deviceManager.addChangeListener (this);
 
@@ -156,6 +626,9 @@ void Player::initialise ()
 
 void Player::shutDown ()
 {
+    stopTimer();
+    stopShuttleReader();
+
     deviceManager.removeChangeListener (this);
     sourcePlayer.setSource (nullptr);
     deviceManager.removeAudioCallback (&sourcePlayer);
@@ -178,9 +651,753 @@ void Player::changeListenerCallback (ChangeBroadcaster* sender)
 
         mixingSource.prepareToPlay (device->getDefaultBufferSize(), device->getCurrentSampleRate());
     }
+
+    updateLoop();
 }
 
 foleys::LevelMeterSource& Player::getMeterSource()
 {
     return transportSource.meterSource;
 }
+
+float Player::getCallbackLoad() const
+{
+    return transportSource.callbackLoad.load();
+}
+
+float Player::getMeterLoad() const
+{
+    return transportSource.meterLoad.load();
+}
+
+void Player::timerCallback()
+{
+    transportSource.updateMeterSource();
+    updateShuttle();
+
+    // the audio thread has moved on, so the old clips are destroyed here and not there
+    if (! releasePool.empty() && clipSource.isIdle())
+        releasePool.clear();
+
+    loopSource.handleSeekRequest();
+
+    if (! releasedPrerolls.empty() && loopSource.isIdle())
+        releasedPrerolls.clear();
+
+    if (! releasedReaders.empty() && shuttleSource.isIdle())
+        releasedReaders.clear();
+
+    if (prerollStale && Time::getMillisecondCounter() >= prerollDue)
+        renderPreroll();
+}
+
+//==============================================================================
+
+void Player::ClipSwapSource::setNextSource (PositionableAudioSource* source)
+{
+    nextSource.store (source);
+    pending.store (true);
+}
+
+bool Player::ClipSwapSource::isIdle() const
+{
+    return ! pending.load() && ! fading.load();
+}
+
+void Player::ClipSwapSource::handlePendingSwap (bool crossfade)
+{
+    if (! crossfade && fadingOut != nullptr)
+    {
+        fadingOut = nullptr;
+        fading.store (false);
+    }
+
+    if (! pending.load())
+        return;
+
+    // fading is raised before pending is cleared, so isIdle() never sees a gap
+    fading.store (true);
+    pending.store (false);
+
+    auto* next = nextSource.load();
+    auto* previous = current.exchange (next);
+
+    if (previous == next)
+    {
+        fading.store (fadingOut != nullptr);
+        return;
+    }
+
+    // a crossfade still running is cut short
+    fadingOut    = crossfade ? previous : nullptr;
+    fadePosition = 0;
+    fading.store (fadingOut != nullptr);
+}
+
+void Player::ClipSwapSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    fadeBuffer.setSize (8, samplesPerBlockExpected);
+    fadeLength = jmax (1, roundToInt (sampleRate * 0.02));
+}
+
+void Player::ClipSwapSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    handlePendingSwap (true);
+
+    if (auto* source = current.load())
+        source->getNextAudioBlock (info);
+    else
+        info.clearActiveBufferRegion();
+
+    if (fadingOut == nullptr)
+        return;
+
+    const auto numSamples = jmin (info.numSamples, fadeLength - fadePosition);
+
+    // a block larger than the prepared one gets a hard cut
+    if (numSamples <= fadeBuffer.getNumSamples())
+    {
+        AudioSourceChannelInfo fadeInfo (&fadeBuffer, 0, numSamples);
+        fadeInfo.clearActiveBufferRegion();
+        fadingOut->getNextAudioBlock (fadeInfo);
+
+        const auto gainStart = 1.0f - float (fadePosition) / fadeLength;
+        const auto gainEnd   = 1.0f - float (fadePosition + numSamples) / fadeLength;
+
+        for (int channel = 0; channel < jmin (info.buffer->getNumChannels(), fadeBuffer.getNumChannels()); ++channel)
+        {
+            info.buffer->applyGainRamp (channel, info.startSample, numSamples, 1.0f - gainStart, 1.0f - gainEnd);
+            info.buffer->addFromWithRamp (channel, info.startSample, fadeBuffer.getReadPointer (channel), numSamples, gainStart, gainEnd);
+        }
+
+        fadePosition += numSamples;
+    }
+    else
+    {
+        fadePosition = fadeLength;
+    }
+
+    if (fadePosition >= fadeLength)
+    {
+        fadingOut = nullptr;
+        fading.store (false);
+    }
+}
+
+void Player::ClipSwapSource::setNextReadPosition (int64 newPosition)
+{
+    if (auto* source = current.load())
+        source->setNextReadPosition (newPosition);
+}
+
+int64 Player::ClipSwapSource::getNextReadPosition() const
+{
+    if (auto* source = current.load())
+        return source->getNextReadPosition();
+
+    return 0;
+}
+
+int64 Player::ClipSwapSource::getTotalLength() const
+{
+    if (auto* source = current.load())
+        return source->getTotalLength();
+
+    return 0;
+}
+
+bool Player::ClipSwapSource::isLooping() const
+{
+    if (auto* source = current.load())
+        return source->isLooping();
+
+    return false;
+}
+
+//==============================================================================
+
+Player::LoopSource::LoopSource (PositionableAudioSource& inputToUse)
+  : input (inputToUse)
+{
+}
+
+void Player::LoopSource::setLoopRange (Range<int64> range)
+{
+    jassert (range.getStart() >= 0 && range.getEnd() <= std::numeric_limits<uint32>::max());
+
+    const auto start = uint64 (jlimit<int64> (0, std::numeric_limits<uint32>::max(), range.getStart()));
+    const auto end   = uint64 (jlimit<int64> (0, std::numeric_limits<uint32>::max(), range.getEnd()));
+    loopRange.store (int64 ((start << 32) | end));
+}
+
+Range<int64> Player::LoopSource::getLoopRange() const
+{
+    const auto packed = uint64 (loopRange.load());
+    return { int64 (packed >> 32), int64 (packed & 0xffffffff) };
+}
+
+void Player::LoopSource::setPreroll (Preroll* prerollToUse)
+{
+    // the pointer is stored before the count, so a block seeing the new count sees the new pointer
+    nextPreroll.store (prerollToUse);
+    ++prerollRequests;
+}
+
+bool Player::LoopSource::isIdle() const
+{
+    return prerollAcknowledged.load() == prerollRequests.load();
+}
+
+void Player::LoopSource::handleSeekRequest()
+{
+    const auto start = seekRequest.exchange (-1);
+    if (start < 0)
+        return;
+
+    // a bit ahead of the preroll, so the audio thread hasn't passed the position when it finds the clip there
+    const auto target = jmin (seekLimit.load(), start + playedSamples.load() + seekLead);
+    seekTarget.store (target);
+    input.setNextReadPosition (target);
+}
+
+void Player::LoopSource::cancelSeekRequest()
+{
+    seekRequest.store (-1);
+    seekTarget.store (seekCancelled);
+}
+
+void Player::LoopSource::raiseSeekRequest (int64 start)
+{
+    wrapStart = start;
+    sinceWrap = 0;
+
+    // a request still waiting for the message thread is answered for this wraparound as well
+    if (waitingForSeek)
+        return;
+
+    heldPosition   = input.getNextReadPosition();
+    waitingForSeek = true;
+
+    seekTarget.store (-1);
+    seekLimit.store (start + (prerollPosition == 0 ? preroll->buffer.getNumSamples() : 0));
+    seekRequest.store (start);
+}
+
+bool Player::LoopSource::isInputHeld() const
+{
+    if (waitingForSeek)
+        return true;
+
+    return prerollPosition >= 0
+        && heldPosition > preroll->start + prerollPosition
+        && input.getNextReadPosition() == heldPosition;
+}
+
+void Player::LoopSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    input.prepareToPlay (samplesPerBlockExpected, sampleRate);
+    behindBuffer.setSize (8, samplesPerBlockExpected);
+    prerollPosition = -1;
+    waitingForSeek  = false;
+    seekLead = int64 (0.1 * sampleRate);
+}
+
+void Player::LoopSource::releaseResources()
+{
+    input.releaseResources();
+}
+
+void Player::LoopSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const auto request = prerollRequests.load();
+    if (request != prerollSeen)
+    {
+        preroll = nextPreroll.load();
+        prerollPosition = -1;
+        prerollSeen = request;
+    }
+
+    const auto range = getLoopRange();
+
+    if (range.isEmpty())
+        readSegment (info);
+    else
+        readLoop (info, range.getStart(), range.getEnd());
+
+    // the previous prerolls are not touched after this block
+    prerollAcknowledged.store (prerollSeen);
+}
+
+void Player::LoopSource::readLoop (const AudioSourceChannelInfo& info, int64 start, int64 end)
+{
+    // a loop shorter than the block wraps several times
+    for (int done = 0; done < info.numSamples;)
+    {
+        // while the clip is held the loop moves on with the preroll
+        const auto position = isInputHeld() ? wrapStart + sinceWrap : input.getNextReadPosition();
+        const auto wraps = position < end && position + (info.numSamples - done) >= end;
+        const auto numSamples = wraps ? int (end - position) : info.numSamples - done;
+
+        readSegment (AudioSourceChannelInfo (info.buffer, info.startSample + done, numSamples));
+        done += numSamples;
+        sinceWrap += numSamples;
+
+        if (wraps)
+        {
+            prerollPosition = (preroll != nullptr && preroll->start == start) ? 0 : -1;
+            raiseSeekRequest (start);
+        }
+    }
+
+    playedSamples.store (sinceWrap);
+}
+
+void Player::LoopSource::readSegment (const AudioSourceChannelInfo& info)
+{
+    const auto position = input.getNextReadPosition();
+
+    if (waitingForSeek)
+    {
+        const auto target = seekTarget.load();
+
+        if (target >= 0 && position == target)
+        {
+            waitingForSeek = false;
+            heldPosition   = target;
+        }
+        else if (target == seekCancelled || position != heldPosition)
+        {
+            // the clip was moved from outside, so the wraparound is dropped
+            waitingForSeek  = false;
+            prerollPosition = -1;
+        }
+    }
+
+    if (prerollPosition < 0 || info.numSamples > behindBuffer.getNumSamples())
+    {
+        prerollPosition = -1;
+
+        // without a preroll it is silent until the message thread moved the clip
+        if (waitingForSeek)
+            info.clearActiveBufferRegion();
+        else
+            input.getNextAudioBlock (info);
+
+        return;
+    }
+
+    const auto prerollAt = preroll->start + prerollPosition;
+    const auto held = isInputHeld();
+
+    // a seek from outside while the preroll plays leaves the preroll
+    if (! held && position != prerollAt)
+    {
+        prerollPosition = -1;
+        input.getNextAudioBlock (info);
+        return;
+    }
+
+    // the clip is read again where the preroll reaches it
+    if (held && ! waitingForSeek && heldPosition - prerollAt < info.numSamples)
+    {
+        const auto numHeld = int (heldPosition - prerollAt);
+        readSegment (AudioSourceChannelInfo (info.buffer, info.startSample, numHeld));
+        readSegment (AudioSourceChannelInfo (info.buffer, info.startSample + numHeld, info.numSamples - numHeld));
+        return;
+    }
+
+    // the clip keeps reading behind the preroll, so its decoders catch up and its timecode moves on
+    AudioSourceChannelInfo behind (&behindBuffer, 0, info.numSamples);
+    behind.clearActiveBufferRegion();
+
+    if (! held)
+        input.getNextAudioBlock (behind);
+
+    const auto& buffer = preroll->buffer;
+    const auto fromPreroll = jmin (info.numSamples, buffer.getNumSamples() - prerollPosition);
+
+    for (int channel = 0; channel < info.buffer->getNumChannels(); ++channel)
+    {
+        if (channel < buffer.getNumChannels())
+            info.buffer->copyFrom (channel, info.startSample, buffer, channel, prerollPosition, fromPreroll);
+        else
+            info.buffer->clear (channel, info.startSample, fromPreroll);
+
+        if (fromPreroll < info.numSamples)
+        {
+            if (channel < behindBuffer.getNumChannels())
+                info.buffer->copyFrom (channel, info.startSample + fromPreroll, behindBuffer, channel, fromPreroll, info.numSamples - fromPreroll);
+            else
+                info.buffer->clear (channel, info.startSample + fromPreroll, info.numSamples - fromPreroll);
+        }
+    }
+
+    prerollPosition += fromPreroll;
+    if (prerollPosition >= buffer.getNumSamples())
+        prerollPosition = -1;
+}
+
+void Player::LoopSource::setNextReadPosition (int64 newPosition)
+{
+    input.setNextReadPosition (newPosition);
+}
+
+int64 Player::LoopSource::getNextReadPosition() const
+{
+    return input.getNextReadPosition();
+}
+
+int64 Player::LoopSource::getTotalLength() const
+{
+    return input.getTotalLength();
+}
+
+bool Player::LoopSource::isLooping() const
+{
+    return input.isLooping() || ! getLoopRange().isEmpty();
+}
+
+//==============================================================================
+
+Player::ShuttleReader::ShuttleReader (int numChannels, int capacity)
+  : buffer (numChannels, capacity),
+    fifo (capacity)
+{
+}
+
+bool Player::ShuttleReader::write (const AudioBuffer<float>& source, int numSamples)
+{
+    int written = 0;
+    while (written < numSamples)
+    {
+        if (stopped.load())
+            return false;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numSamples - written, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+        {
+            Thread::sleep (5);
+            continue;
+        }
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            if (size1 > 0)
+                buffer.copyFrom (channel, start1, source, channel, written, size1);
+
+            if (size2 > 0)
+                buffer.copyFrom (channel, start2, source, channel, written + size1, size2);
+        }
+
+        fifo.finishedWrite (size1 + size2);
+        written += size1 + size2;
+    }
+
+    return ! stopped.load();
+}
+
+void Player::ShuttleReader::read (AudioBuffer<float>& dest, int startSample, int numSamples)
+{
+    int start1, size1, start2, size2;
+
+    // the samples that were silent are behind the picture now
+    if (owed > 0)
+    {
+        fifo.prepareToRead (int (jmin (owed, int64 (fifo.getNumReady()))), start1, size1, start2, size2);
+        fifo.finishedRead (size1 + size2);
+        owed -= size1 + size2;
+    }
+
+    fifo.prepareToRead (numSamples, start1, size1, start2, size2);
+
+    const auto numChannels = jmin (dest.getNumChannels(), buffer.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        if (size1 > 0)
+            dest.copyFrom (channel, startSample, buffer, channel, start1, size1);
+
+        if (size2 > 0)
+            dest.copyFrom (channel, startSample + size1, buffer, channel, start2, size2);
+    }
+
+    for (int channel = numChannels; channel < dest.getNumChannels(); ++channel)
+        dest.clear (channel, startSample, size1 + size2);
+
+    fifo.finishedRead (size1 + size2);
+
+    const auto missing = numSamples - size1 - size2;
+    if (missing > 0)
+    {
+        dest.clear (startSample + size1 + size2, missing);
+        owed += missing;
+    }
+}
+
+//==============================================================================
+
+Player::ShuttleSource::ShuttleSource (PositionableAudioSource& inputToUse)
+  : input (inputToUse)
+{
+}
+
+void Player::ShuttleSource::setSpeed (double newSpeed)
+{
+    speed.store (jlimit (-maxSpeed, maxSpeed, newSpeed));
+}
+
+void Player::ShuttleSource::setReader (ShuttleReader* newReader)
+{
+    nextReader.store (newReader);
+    ++readerRequests;
+}
+
+bool Player::ShuttleSource::isIdle() const
+{
+    return readerAcknowledged.load() == readerRequests.load();
+}
+
+void Player::ShuttleSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    input.prepareToPlay (samplesPerBlockExpected, sampleRate);
+    inputBuffer.setSize (8, int (std::ceil (samplesPerBlockExpected * maxSpeed)) + 4);
+    resampling = false;
+}
+
+void Player::ShuttleSource::releaseResources()
+{
+    input.releaseResources();
+}
+
+void Player::ShuttleSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const auto requests = readerRequests.load();
+    if (requests != readerSeen)
+    {
+        readerSeen = requests;
+        reader     = nextReader.load();
+        resampling = false;
+        fadeIn     = true;
+    }
+
+    const auto currentSpeed = speed.load();
+    const auto ratio = std::abs (currentSpeed);
+
+    // backwards only the reader has samples
+    if (currentSpeed < 0.0 && reader == nullptr)
+    {
+        info.clearActiveBufferRegion();
+        readerAcknowledged.store (readerSeen);
+        return;
+    }
+
+    if ((ratio != 1.0 || reader != nullptr) && ! resampling)
+    {
+        // the end of the previous block is unknown after passing through
+        inputBuffer.clear (0, 2);
+        subPosition = 0.0;
+        resampling  = true;
+        fadeIn      = true;
+    }
+
+    // input samples needed to interpolate the last output sample
+    const auto numInput = int (std::floor (subPosition + (info.numSamples - 1) * ratio)) + 1;
+
+    // a block larger than the prepared one is played at normal speed, or silent from a reader
+    if ((ratio == 1.0 && reader == nullptr) || numInput + 2 > inputBuffer.getNumSamples())
+    {
+        resampling = false;
+
+        if (reader == nullptr)
+            input.getNextAudioBlock (info);
+        else
+            info.clearActiveBufferRegion();
+    }
+    else
+    {
+        AudioSourceChannelInfo inputInfo (&inputBuffer, 2, numInput);
+        inputInfo.clearActiveBufferRegion();
+
+        if (numInput > 0)
+        {
+            if (reader != nullptr)
+                reader->read (inputBuffer, 2, numInput);
+            else
+                input.getNextAudioBlock (inputInfo);
+        }
+
+        const auto numChannels = jmin (info.buffer->getNumChannels(), inputBuffer.getNumChannels());
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* source = inputBuffer.getWritePointer (channel);
+            auto* dest   = info.buffer->getWritePointer (channel, info.startSample);
+            auto position = 1.0 + subPosition;
+
+            for (int i = 0; i < info.numSamples; ++i)
+            {
+                const auto index = int (position);
+                const auto alpha = float (position - index);
+                dest [i] = source [index] + alpha * (source [index + 1] - source [index]);
+                position += ratio;
+            }
+
+            const auto last = source [numInput + 1];
+            source [0] = source [numInput];
+            source [1] = last;
+        }
+
+        for (int channel = numChannels; channel < info.buffer->getNumChannels(); ++channel)
+            info.buffer->clear (channel, info.startSample, info.numSamples);
+
+        subPosition += info.numSamples * ratio - numInput;
+    }
+
+    if (fadeIn)
+    {
+        fadeIn = false;
+        for (int channel = 0; channel < info.buffer->getNumChannels(); ++channel)
+            info.buffer->applyGainRamp (channel, info.startSample, info.numSamples, 0.0f, 1.0f);
+    }
+
+    readerAcknowledged.store (readerSeen);
+}
+
+void Player::ShuttleSource::setNextReadPosition (int64 newPosition)
+{
+    input.setNextReadPosition (newPosition);
+}
+
+int64 Player::ShuttleSource::getNextReadPosition() const
+{
+    return input.getNextReadPosition();
+}
+
+int64 Player::ShuttleSource::getTotalLength() const
+{
+    return input.getTotalLength();
+}
+
+bool Player::ShuttleSource::isLooping() const
+{
+    return input.isLooping();
+}
+
+//==============================================================================
+
+Player::MeasuredTransportSource::MeasuredTransportSource (ClipSwapSource& source, ShuttleSource& shuttle)
+  : clipSource (source)
+{
+    setSource (&shuttle);
+    blocks.resize (size_t (fifo.getTotalSize()));
+    meterBuffer.setSize (maxChannels, 1024);
+}
+
+void Player::MeasuredTransportSource::prepareToPlay (int samplesPerBlockExpected, double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    AudioTransportSource::prepareToPlay (samplesPerBlockExpected, newSampleRate);
+}
+
+void Player::MeasuredTransportSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const auto startTicks = Time::getHighResolutionTicks();
+
+    // the transport only pulls the clipSource while playing, a swap while stopped needs no fade
+    if (! isPlaying())
+        clipSource.handlePendingSwap (false);
+
+    AudioTransportSource::getNextAudioBlock (info);
+
+    const auto meterTicks  = Time::getHighResolutionTicks();
+    const auto numChannels = info.buffer->getNumChannels();
+    const auto measure     = isPlaying();
+
+    BlockLevels levels;
+    levels.numChannels = jmin (numChannels, maxChannels);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = info.buffer->getWritePointer (channel, info.startSample);
+        auto peak = 0.0f;
+        auto sumOfSquares = 0.0f;
+
+        if (clipOutput)
+            measureAndClip<true> (data, info.numSamples, peak, sumOfSquares);
+        else if (measure)
+            measureAndClip<false> (data, info.numSamples, peak, sumOfSquares);
+
+        if (channel < maxChannels)
+        {
+            levels.peak [size_t (channel)] = peak;
+            levels.rms  [size_t (channel)] = info.numSamples > 0 ? std::sqrt (sumOfSquares / info.numSamples) : 0.0f;
+        }
+    }
+
+    // if the message thread falls behind the block is dropped, the meter is not worth waiting for
+    if (measure && fifo.getFreeSpace() > 0)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+        blocks [size_t (size1 > 0 ? start1 : start2)] = levels;
+        fifo.finishedWrite (1);
+    }
+
+    const auto endTicks = Time::getHighResolutionTicks();
+    const auto budget   = sampleRate > 0.0 ? info.numSamples / sampleRate : 0.0;
+    updateLoad (meterLoad, Time::highResolutionTicksToSeconds (endTicks - meterTicks), budget);
+    updateLoad (callbackLoad, Time::highResolutionTicksToSeconds (endTicks - startTicks), budget);
+}
+
+void Player::MeasuredTransportSource::updateMeterSource()
+{
+    const auto numReady = fifo.getNumReady();
+    if (numReady == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+    BlockLevels combined;
+    combined.peak.fill (0.0f);
+    combined.rms.fill (0.0f);
+
+    auto combine = [&](int start, int size)
+    {
+        for (int i = start; i < start + size; ++i)
+        {
+            const auto& block = blocks [size_t (i)];
+            combined.numChannels = jmax (combined.numChannels, block.numChannels);
+
+            for (int channel = 0; channel < block.numChannels; ++channel)
+            {
+                combined.peak [size_t (channel)] = jmax (combined.peak [size_t (channel)], block.peak [size_t (channel)]);
+                combined.rms  [size_t (channel)] += block.rms [size_t (channel)] * block.rms [size_t (channel)] / numReady;
+            }
+        }
+    };
+
+    combine (start1, size1);
+    combine (start2, size2);
+    fifo.finishedRead (size1 + size2);
+
+    // The LevelMeterSource only measures buffers, so a buffer with the same
+    // peak and RMS stands in for the blocks: one peak sample, the rest filled
+    // up to the mean square.
+    const auto length = meterBuffer.getNumSamples();
+    meterBuffer.setSize (combined.numChannels, length, false, false, true);
+
+    for (int channel = 0; channel < combined.numChannels; ++channel)
+    {
+        const auto peak = combined.peak [size_t (channel)];
+        const auto meanSquare = combined.rms [size_t (channel)];
+        const auto rest = std::sqrt (jmax (0.0f, (length * meanSquare - peak * peak) / (length - 1)));
+
+        meterBuffer.setSample (channel, 0, peak);
+        FloatVectorOperations::fill (meterBuffer.getWritePointer (channel, 1), jmin (rest, peak), length - 1);
+    }
+
+    meterSource.measureBlock (meterBuffer);
+}
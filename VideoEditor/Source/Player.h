@@ -27,18 +27,24 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "PrefetchedPreview.h"
 
 //==============================================================================
 /*
 */
 class Player  : public ChangeBroadcaster,
-                public ChangeListener
+                public ChangeListener,
+                private ValueTree::Listener,
+                private Timer
 {
 public:
-    Player (AudioDeviceManager& deviceManager, foleys::VideoEngine& engine, foleys::VideoPreview& preview);
+    Player (AudioDeviceManager& deviceManager, foleys::VideoEngine& engine, PrefetchedPreview& preview);
     ~Player();
 
-    void setClip (std::shared_ptr<foleys::AVClip> clip, bool needsPrepare);
+    /** Sets the clip to play. If it needs preparing, that happens on the pool and the current clip
+        plays until then. onReady is called on the message thread once the clip is swapped in,
+        it is dropped if another clip is set meanwhile. */
+    void setClip (std::shared_ptr<foleys::AVClip> clip, bool needsPrepare, std::function<void()> onReady = {});
 
     void start();
     void stop();
@@ -46,6 +52,22 @@ public:
 
     void setPosition (double pts);
 
+    /** Plays at speed times realtime, negative speeds play backwards and 0 stops.
+        Changing the speed while playing doesn't rebuild the audio chain. */
+    void setShuttleSpeed (double speed);
+    double getShuttleSpeed() const;
+
+    /** The L and J keys: each press doubles the speed in that direction, slow starts at quarter speed */
+    void shuttleForward (bool slow);
+    void shuttleBackward (bool slow);
+
+    /** Sets the range in seconds to play in a loop. While the loop end plays the loop start is pre-rolled. */
+    void setLoopRange (Range<double> range);
+    Range<double> getLoopRange() const;
+
+    void setLooping (bool shouldLoop);
+    bool isLooping() const;
+
     double getCurrentTimeInSeconds() const;
 
     void setAuditionFile (const File& file);
@@ -62,52 +84,345 @@ public:
 
     void changeListenerCallback (ChangeBroadcaster* sender) override;
 
-    class MeasuredTransportSource : public AudioTransportSource
+    /** Returns the time spent rendering the clip audio relative to the buffer duration */
+    float getCallbackLoad() const;
+
+    /** Returns the time spent in the meter and clip pass relative to the buffer duration */
+    float getMeterLoad() const;
+
+    /*
+        Plays the current clip and swaps in a new one on the audio thread. The
+        message thread only publishes the next clip, the audio thread picks it
+        up at the start of a block and crossfades from the previous one.
+    */
+    class ClipSwapSource : public PositionableAudioSource
+    {
+    public:
+        ClipSwapSource() = default;
+
+        /** Called on the message thread, the source must be prepared already */
+        void setNextSource (PositionableAudioSource* source);
+
+        /** Returns true if no swap or crossfade is pending, so previous sources can be released */
+        bool isIdle() const;
+
+        /** Called on the audio thread to pick up a pending source */
+        void handlePendingSwap (bool crossfade);
+
+        void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+        void releaseResources() override {}
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override;
+
+        void setNextReadPosition (int64 newPosition) override;
+        int64 getNextReadPosition() const override;
+        int64 getTotalLength() const override;
+        bool isLooping() const override;
+
+    private:
+        std::atomic<PositionableAudioSource*> current     { nullptr };
+        std::atomic<PositionableAudioSource*> nextSource  { nullptr };
+        std::atomic<bool> pending { false };
+        std::atomic<bool> fading  { false };
+
+        // only accessed on the audio thread
+        PositionableAudioSource* fadingOut = nullptr;
+        AudioBuffer<float> fadeBuffer;
+        int fadeLength   = 0;
+        int fadePosition = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClipSwapSource)
+    };
+
+    /*
+        Jumps from the loop end back to the loop start inside the block, so the
+        wraparound is sample accurate. The audio after the loop start is rendered
+        ahead into a Preroll from a copy of the clip and is played from memory,
+        while the clip behind it seeks and fills its buffers.
+
+        Seeking the clip isn't realtime safe, so the audio thread doesn't move
+        the clip at the wraparound. It stops reading the clip and asks the
+        message thread to move it a bit ahead of the preroll. Then it reads
+        the clip again from where the preroll catches up with it.
+    */
+    class LoopSource : public PositionableAudioSource
     {
     public:
-        MeasuredTransportSource() = default;
+        LoopSource (PositionableAudioSource& input);
 
-        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        struct Preroll
         {
-            AudioTransportSource::getNextAudioBlock (info);
-
-            if (isPlaying())
-            {
-                AudioBuffer<float> proxy (info.buffer->getArrayOfWritePointers(),
-                                          info.buffer->getNumChannels(),
-                                          info.startSample,
-                                          info.numSamples);
-                meterSource.measureBlock (proxy);
-            }
-
-            if (clipOutput)
-            {
-                for (int channel = 0; channel < info.buffer->getNumChannels(); ++channel)
-                    FloatVectorOperations::clip (info.buffer->getWritePointer (channel, info.startSample),
-                                                 info.buffer->getReadPointer (channel, info.startSample),
-                                                 -1.0f, 1.0f, info.numSamples);
-            }
-        }
+            int64 start = 0;
+            AudioBuffer<float> buffer;
+        };
+
+        /** Called on the message thread, an empty range switches looping off. Positions must fit into 32 bits. */
+        void setLoopRange (Range<int64> range);
+
+        /** Called on the message thread, the preroll must be kept until isIdle() */
+        void setPreroll (Preroll* preroll);
+
+        /** Returns true if the audio thread has finished a block with the last preroll, so previous ones can be released */
+        bool isIdle() const;
+
+        /** Called on the message thread to move the clip back to the loop start after a wraparound */
+        void handleSeekRequest();
+
+        /** Called on the message thread after the clip was moved from outside, a wraparound is dropped */
+        void cancelSeekRequest();
+
+        void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+        void releaseResources() override;
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override;
+
+        void setNextReadPosition (int64 newPosition) override;
+        int64 getNextReadPosition() const override;
+        int64 getTotalLength() const override;
+        bool isLooping() const override;
+
+    private:
+        void readLoop (const AudioSourceChannelInfo& info, int64 start, int64 end);
+        void readSegment (const AudioSourceChannelInfo& info);
+
+        /** Returns true while the clip is not read, because it waits for a seek or is ahead of the preroll */
+        bool isInputHeld() const;
+        void raiseSeekRequest (int64 start);
+
+        static constexpr int64 seekCancelled = -2;
+
+        PositionableAudioSource& input;
+        Range<int64> getLoopRange() const;
+
+        // start and end packed into one value, so the audio thread never sees a start and an end of different ranges
+        std::atomic<int64> loopRange { 0 };
+
+        // each setPreroll is counted, the audio thread acknowledges the count after the block it picked the preroll up
+        std::atomic<Preroll*> nextPreroll { nullptr };
+        std::atomic<int> prerollRequests     { 0 };
+        std::atomic<int> prerollAcknowledged { 0 };
+
+        // the audio thread asks for a seek to the loop start, the message thread answers with the position it moved the clip to
+        std::atomic<int64> seekRequest   { -1 };
+        std::atomic<int64> seekLimit     { 0 };
+        std::atomic<int64> seekTarget    { -1 };
+        std::atomic<int64> playedSamples { 0 };
+        int64 seekLead = 0;
+
+        // only accessed on the audio thread
+        Preroll* preroll = nullptr;
+        int prerollSeen = 0;
+        int prerollPosition = -1;
+        AudioBuffer<float> behindBuffer;
+        bool  waitingForSeek = false;
+        int64 heldPosition   = 0;
+        int64 wrapStart      = 0;
+        int64 sinceWrap      = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoopSource)
+    };
+
+    /*
+        The audio for the shuttle speeds the ShuttleSource can't read from its
+        input: backwards and faster than maxInputSpeed, while the clip is moved
+        for the picture. A job reads a copy of the clip in chunks at its natural
+        rate. Backwards it seeks the copy to each chunk before the last one and
+        writes it reversed, so the audio thread always reads forward through the
+        fifo and resamples it like its input.
+    */
+    class ShuttleReader
+    {
+    public:
+        ShuttleReader (int numChannels, int capacity);
+
+        /** Called by the job, waits while the fifo is full. Returns false once the reader was stopped. */
+        bool write (const AudioBuffer<float>& source, int numSamples);
+
+        /** Called on the audio thread. Samples that didn't arrive in time are silent and skipped
+            when they arrive, so the audio keeps up with the picture. */
+        void read (AudioBuffer<float>& dest, int startSample, int numSamples);
+
+        void stop()                     { stopped.store (true); }
+        bool isStopped() const          { return stopped.load(); }
+        int  getNumChannels() const     { return buffer.getNumChannels(); }
+
+    private:
+        AudioBuffer<float> buffer;
+        AbstractFifo       fifo;
+        std::atomic<bool>  stopped { false };
+
+        // only accessed on the audio thread
+        int64 owed = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ShuttleReader)
+    };
+
+    /*
+        Reads its input faster or slower than realtime by interpolating between
+        the samples, so the pitch follows the speed like a tape. The speed is an
+        atomic, so the transport chain stays as it is. At speed 1 the input is
+        passed through untouched.
+
+        With a ShuttleReader the samples come from the reader instead of the
+        input, that is how it plays backwards and faster than maxInputSpeed.
+    */
+    class ShuttleSource : public PositionableAudioSource
+    {
+    public:
+        ShuttleSource (PositionableAudioSource& input);
+
+        /** Set the speed between -maxSpeed and maxSpeed, can be called from any thread.
+            Negative speeds are silent without a reader. */
+        void setSpeed (double newSpeed);
+
+        /** Called on the message thread, the reader must be kept until isIdle(). nullptr reads the input again. */
+        void setReader (ShuttleReader* reader);
+
+        /** Returns true if the audio thread has finished a block with the last reader, so previous ones can be released */
+        bool isIdle() const;
+
+        void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+        void releaseResources() override;
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override;
+
+        void setNextReadPosition (int64 newPosition) override;
+        int64 getNextReadPosition() const override;
+        int64 getTotalLength() const override;
+        bool isLooping() const override;
+
+        static constexpr double maxSpeed      = 8.0;
+        static constexpr double maxInputSpeed = 2.0;
+
+    private:
+        PositionableAudioSource& input;
+        std::atomic<double> speed  { 1.0 };
+
+        // each setReader is counted, the audio thread acknowledges the count after the block it picked the reader up
+        std::atomic<ShuttleReader*> nextReader { nullptr };
+        std::atomic<int> readerRequests     { 0 };
+        std::atomic<int> readerAcknowledged { 0 };
+
+        // only accessed on the audio thread, the first two samples are the end of the previous block
+        AudioBuffer<float> inputBuffer;
+        ShuttleReader* reader = nullptr;
+        int    readerSeen  = 0;
+        double subPosition = 0.0;
+        bool   resampling  = false;
+        bool   fadeIn      = false;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ShuttleSource)
+    };
+
+    /*
+        Measures peak and RMS while clipping the output in one pass per channel.
+        The levels of each block are pushed into a wait-free FIFO, the message
+        thread pulls them out and forwards them to the LevelMeterSource.
+    */
+    class MeasuredTransportSource : public AudioTransportSource
+    {
+    public:
+        MeasuredTransportSource (ClipSwapSource& source, ShuttleSource& shuttle);
+
+        void prepareToPlay (int samplesPerBlockExpected, double newSampleRate) override;
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override;
+
+        /** Called on the message thread to forward the measured blocks to the meterSource */
+        void updateMeterSource();
 
         foleys::LevelMeterSource meterSource;
+        ClipSwapSource&          clipSource;
+
+        std::atomic<float> callbackLoad { 0.0f };
+        std::atomic<float> meterLoad    { 0.0f };
 
     private:
+        static constexpr int maxChannels = 8;
+
+        struct BlockLevels
+        {
+            int numChannels = 0;
+            std::array<float, maxChannels> peak;
+            std::array<float, maxChannels> rms;
+        };
+
+        AbstractFifo             fifo { 256 };
+        std::vector<BlockLevels> blocks;
+
+        AudioBuffer<float>       meterBuffer;
+        double sampleRate = 0.0;
         const bool clipOutput = true;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeasuredTransportSource)
     };
 private:
+    void timerCallback() override;
+
+    /** Makes a prepared clip the current one */
+    void swapClip (std::shared_ptr<foleys::AVClip> newClip);
+
+    /** Backwards and faster than the ShuttleSource reads its input, the audio comes from a
+        ShuttleReader and the clip is jumped from the timer for the picture */
+    bool isJumping() const;
+    void updateShuttle();
+    void startShuttleReader();
+    void stopShuttleReader();
+
+    /** Returns a function that creates a copy of the clip for reading its audio on the pool */
+    std::function<std::shared_ptr<foleys::AVClip>()> getCopyFunction() const;
+
+    void updateLoop();
+    void renderPreroll();
+
+    void valueTreePropertyChanged (ValueTree&, const Identifier&) override   { invalidatePreroll(); }
+    void valueTreeChildAdded (ValueTree&, ValueTree&) override               { invalidatePreroll(); }
+    void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override        { invalidatePreroll(); }
+    void valueTreeChildOrderChanged (ValueTree&, int, int) override          { invalidatePreroll(); }
+    void valueTreeParentChanged (ValueTree&) override {}
+
+    /** The preroll is rendered again once the edit stopped changing for a moment */
+    void invalidatePreroll();
+
     AudioDeviceManager& deviceManager;
     foleys::VideoEngine& videoEngine;
 
     juce::MixerAudioSource      mixingSource;
     std::shared_ptr<foleys::AVClip> clip;
-    MeasuredTransportSource     transportSource;
+    ClipSwapSource              clipSource;
+    LoopSource                  loopSource      { clipSource };
+    ShuttleSource               shuttleSource   { loopSource };
+    MeasuredTransportSource     transportSource { clipSource, shuttleSource };
     AudioSourcePlayer           sourcePlayer;
-    foleys::VideoPreview&       preview;
+    PrefetchedPreview&          preview;
 
     std::unique_ptr<juce::PositionableAudioSource> auditionSource;
     juce::AudioTransportSource  auditionTransport;
 
+    // clips swapped out, kept until the audio thread has let go of them
+    std::vector<std::shared_ptr<foleys::AVClip>> releasePool;
+
+    // a clip is prepared by one job at a time, the clip set last is swapped in when its job is done
+    std::vector<std::shared_ptr<foleys::AVClip>> clipsInPreparation;
+    std::shared_ptr<foleys::AVClip> pendingClip;
+    std::function<void()> onClipReady;
+    bool   preparing       = false;
+    double pendingPosition = 0.0;
+
+    double shuttleSpeed    = 1.0;
+    double shuttlePosition = 0.0;
+    double shuttleTarget   = -1.0;
+    double lastShuttleTick = 0.0;
+    std::shared_ptr<ShuttleReader> shuttleReader;
+    std::vector<std::shared_ptr<ShuttleReader>> releasedReaders;
+    static constexpr double shuttleChunkSeconds = 0.25;
+
+    static constexpr double prerollSeconds = 0.5;
+    ValueTree     statusTree;
+    Range<double> loopRange;
+    bool   looping          = false;
+    bool   prerollStale     = false;
+    uint32 prerollDue       = 0;
+    int    prerollGeneration = 0;
+    std::shared_ptr<LoopSource::Preroll> preroll;
+    std::vector<std::shared_ptr<LoopSource::Preroll>> releasedPrerolls;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (Player)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Player)
 };
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    PrefetchedPreview.cpp
+    Created: 17 Oct 2026 8:51:22pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "PrefetchedPreview.h"
+
+//==============================================================================
+
+PrefetchedPreview::PrefetchedPreview (foleys::VideoEngine& videoEngine)
+  : prefetcher (videoEngine)
+{
+    prefetcher.onSeekFrameReady = [this] { repaint(); };
+}
+
+PrefetchedPreview::~PrefetchedPreview()
+{
+}
+
+void PrefetchedPreview::setClip (std::shared_ptr<foleys::AVClip> clip)
+{
+    foleys::VideoPreview::setClip (clip);
+
+    currentTime.store (clip != nullptr ? clip->getCurrentTimeInSeconds() : 0.0);
+    prefetcher.setClip (clip);
+    prefetcher.setFrameSize (getWidth(), getHeight());
+}
+
+void PrefetchedPreview::setPosition (double seconds)
+{
+    currentTime.store (seconds);
+    prefetcher.reset (seconds);
+    repaint();
+}
+
+void PrefetchedPreview::timecodeChanged (int64_t count, double seconds)
+{
+    currentTime.store (seconds);
+    prefetcher.setPlayhead (seconds);
+
+    foleys::VideoPreview::timecodeChanged (count, seconds);
+}
+
+void PrefetchedPreview::paint (Graphics& g)
+{
+    auto frame = prefetcher.getFrame (currentTime.load());
+    if (! frame.isValid())
+    {
+        foleys::VideoPreview::paint (g);
+        return;
+    }
+
+    g.fillAll (Colours::black);
+    g.drawImage (frame, getLocalBounds().toFloat(), RectanglePlacement::centred);
+}
+
+void PrefetchedPreview::resized()
+{
+    foleys::VideoPreview::resized();
+    prefetcher.setFrameSize (getWidth(), getHeight());
+}
+
+FramePrefetcher& PrefetchedPreview::getPrefetcher()
+{
+    return prefetcher;
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    PrefetchedPreview.h
+    Created: 17 Oct 2026 8:51:22pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "FramePrefetcher.h"
+
+//==============================================================================
+/*
+    A VideoPreview that shows the frames prepared by a FramePrefetcher. Frames
+    that are not in the window yet are decoded on demand by the VideoPreview.
+*/
+class PrefetchedPreview  : public foleys::VideoPreview
+{
+public:
+    PrefetchedPreview (foleys::VideoEngine& videoEngine);
+    ~PrefetchedPreview();
+
+    void setClip (std::shared_ptr<foleys::AVClip> clip);
+
+    /** Call this when the play position jumps, it drops the prefetched frames */
+    void setPosition (double seconds);
+
+    void timecodeChanged (int64_t count, double seconds) override;
+
+    void paint (Graphics& g) override;
+    void resized() override;
+
+    FramePrefetcher& getPrefetcher();
+
+private:
+    FramePrefetcher prefetcher;
+    std::atomic<double> currentTime { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PrefetchedPreview)
+};
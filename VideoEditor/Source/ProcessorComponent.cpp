@@ -80,6 +80,7 @@ ProcessorComponent::ProcessorComponent (foleys::ProcessorController& controllerT
     {
         auto component = std::make_unique<ParameterComponent>(controller.getOwningClipDescriptor(), *parameter.second, player);
         addAndMakeVisible (component.get());
+        curves.push_back (&component->getCurve());
         parameterComponents.push_back (std::move (component));
     }
 
@@ -169,9 +170,15 @@ int ProcessorComponent::getHeightForWidth(int width) const
 
 void ProcessorComponent::timecodeChanged (int64_t count, double seconds)
 {
-    auto localTime = controller.getOwningClipDescriptor().getClipTimeInDescriptorTime (seconds);
-    for (auto& c : parameterComponents)
-        c->updateForTime (localTime);
+    updateForTime (controller.getOwningClipDescriptor().getClipTimeInDescriptorTime (seconds));
+}
+
+void ProcessorComponent::updateForTime (double localTime)
+{
+    AutomationCurve::getValuesForTime (curves, localTime, values);
+
+    for (size_t i = 0; i < parameterComponents.size(); ++i)
+        parameterComponents [i]->setValue (values [i]);
 }
 
 void ProcessorComponent::processorControllerToBeDeleted (const foleys::ProcessorController* controllerToBeDeleted)
@@ -180,11 +187,13 @@ void ProcessorComponent::processorControllerToBeDeleted (const foleys::Processor
         audioProcessorWindow.reset();
 }
 
-void ProcessorComponent::parameterAutomationChanged (const foleys::ParameterAutomation*)
+void ProcessorComponent::parameterAutomationChanged (const foleys::ParameterAutomation* automation)
 {
-    auto seconds = controller.getOwningClipDescriptor().getCurrentPTS();
     for (auto& c : parameterComponents)
-        c->updateForTime (seconds);
+        if (automation == nullptr || automation == &c->getParameter())
+            c->updateCurve();
+
+    updateForTime (controller.getOwningClipDescriptor().getCurrentPTS());
 }
 
 const foleys::ProcessorController* ProcessorComponent::getProcessorController() const
@@ -406,7 +415,32 @@ void ProcessorComponent::ParameterComponent::resized()
 
 void ProcessorComponent::ParameterComponent::updateForTime (double pts)
 {
-    widget->setValue (parameter.getValueForTime (pts));
+    setValue (curve.getValueForTime (pts));
+}
+
+void ProcessorComponent::ParameterComponent::setValue (double value)
+{
+    if (value == lastValue)
+        return;
+
+    lastValue = value;
+    widget->setValue (value);
+}
+
+void ProcessorComponent::ParameterComponent::updateCurve()
+{
+    curve.update();
+    lastValue = std::numeric_limits<double>::quiet_NaN();
+}
+
+const AutomationCurve& ProcessorComponent::ParameterComponent::getCurve() const
+{
+    return curve;
+}
+
+const foleys::ParameterAutomation& ProcessorComponent::ParameterComponent::getParameter() const
+{
+    return parameter;
 }
 
 //==============================================================================
@@ -27,6 +27,7 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "AutomationCurve.h"
 
 class Player;
 
@@ -76,6 +77,15 @@ public:
 
         void updateForTime (double pts);
 
+        /** Shows the value, the widget is only updated if it changed */
+        void setValue (double value);
+
+        /** Call this when the automation was changed */
+        void updateCurve();
+
+        const AutomationCurve& getCurve() const;
+        const foleys::ParameterAutomation& getParameter() const;
+
         class ParameterWidget
         {
         public:
@@ -94,8 +104,10 @@ public:
     private:
         foleys::ClipDescriptor& clip;
         foleys::ParameterAutomation& parameter;
+        AutomationCurve curve { parameter };
 
         std::unique_ptr<ParameterWidget> widget;
+        double lastValue = std::numeric_limits<double>::quiet_NaN();
 
         TextButton prev { "<" };
         TextButton next { ">" };
@@ -106,6 +118,9 @@ private:
 
     bool isCollapsed() const;
 
+    /** Evaluates all parameters at once and updates the widgets */
+    void updateForTime (double localTime);
+
     TextButton active   { "A" };
     TextButton editor   { "E" };
     TextButton collapse { "v" };
@@ -114,6 +129,8 @@ private:
     foleys::ProcessorController&    controller;
     std::shared_ptr<foleys::AVClip> clip;
     std::vector<std::unique_ptr<ParameterComponent>> parameterComponents;
+    std::vector<const AutomationCurve*> curves;
+    std::vector<double> values;
 
     //==============================================================================
 
@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ProxyManager.cpp
+    Created: 17 Oct 2026 8:55:53pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+#include "ProxyManager.h"
+
+namespace IDs
+{
+    static Identifier proxies   { "Proxies" };
+    static Identifier proxy     { "Proxy" };
+    static Identifier enabled   { "enabled" };
+    static Identifier original  { "original" };
+    static Identifier file      { "file" };
+}
+
+//==============================================================================
+
+class ProxyManager::TranscodeJob  : public ThreadPoolJob
+{
+public:
+    TranscodeJob (ProxyManager& owner, const String& ffmpeg, const File& originalToUse, const File& proxyToUse)
+      : ThreadPoolJob ("Proxy " + originalToUse.getFileName()),
+        manager (&owner),
+        executable (ffmpeg),
+        original (originalToUse),
+        proxy (proxyToUse)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        // the proxy only appears once it is complete, a cancelled job leaves nothing behind
+        TemporaryFile temp (proxy);
+
+        StringArray command { executable, "-y", "-loglevel", "error",
+                              "-i", original.getFullPathName(),
+                              "-vf", "scale=-2:" + String (proxyHeight),
+                              "-c:v", "mjpeg", "-q:v", "5",
+                              "-c:a", "pcm_s16le",
+                              temp.getFile().getFullPathName() };
+
+        ChildProcess process;
+        if (! process.start (command))
+            return finish (false, "The ffmpeg executable \"" + executable + "\" could not be started.");
+
+        while (process.isRunning())
+        {
+            if (shouldExit())
+            {
+                process.kill();
+                return jobHasFinished;
+            }
+
+            Thread::sleep (100);
+        }
+
+        // with -loglevel error ffmpeg only prints the reason it failed
+        if (process.getExitCode() != 0)
+            return finish (false, process.readAllProcessOutput().trim());
+
+        if (! temp.overwriteTargetFileWithTemporary())
+            return finish (false, "The proxy could not be written to \"" + proxy.getFullPathName() + "\".");
+
+        return finish (true, {});
+    }
+
+private:
+    JobStatus finish (bool success, const String& error)
+    {
+        MessageManager::callAsync ([manager = manager, original = original, proxy = proxy, success, error]
+        {
+            if (manager != nullptr)
+                manager->proxyFinished (original, proxy, success, error);
+        });
+
+        return jobHasFinished;
+    }
+
+    WeakReference<ProxyManager> manager;
+    const String executable;
+    const File original;
+    const File proxy;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TranscodeJob)
+};
+
+//==============================================================================
+
+ProxyManager::ProxyManager()
+  : folder (EditFile::getSettingsFolder().getChildFile ("Proxies"))
+{
+    if (auto xml = XmlDocument::parse (folder.getChildFile ("Proxies.xml")))
+        index = ValueTree::fromXml (*xml);
+
+    if (! index.hasType (IDs::proxies))
+        index = ValueTree (IDs::proxies);
+
+    // forget the proxies that were deleted
+    for (int i = index.getNumChildren() - 1; i >= 0; --i)
+        if (! File (index.getChild (i).getProperty (IDs::file).toString()).existsAsFile())
+            index.removeChild (i, nullptr);
+}
+
+ProxyManager::~ProxyManager()
+{
+    threadPool.removeAllJobs (true, 5000);
+}
+
+void ProxyManager::setEnabled (bool shouldBeEnabled)
+{
+    index.setProperty (IDs::enabled, shouldBeEnabled, nullptr);
+    saveIndex();
+    sendChangeMessage();
+}
+
+bool ProxyManager::isEnabled() const
+{
+    return index.getProperty (IDs::enabled, false);
+}
+
+URL ProxyManager::getProxyFor (const URL& original) const
+{
+    if (! isEnabled() || ! original.isLocalFile())
+        return {};
+
+    const auto proxy = getProxyFile (original.getLocalFile());
+    return proxy.existsAsFile() ? URL (proxy) : URL();
+}
+
+void ProxyManager::requestProxy (const URL& original)
+{
+    if (! isEnabled() || ! original.isLocalFile())
+        return;
+
+    const auto file  = original.getLocalFile();
+    const auto proxy = getProxyFile (file);
+
+    if (proxy.existsAsFile() || ! pending.insert (file.getFullPathName()).second)
+        return;
+
+    // the folder is only created once there is something to put in
+    folder.createDirectory();
+    threadPool.addJob (new TranscodeJob (*this, ffmpegExecutable, file, proxy), true);
+}
+
+bool ProxyManager::isCreatingProxies() const
+{
+    return ! pending.empty();
+}
+
+ValueTree ProxyManager::withOriginalMedia (const ValueTree& tree) const
+{
+    return mapMedia (tree, true);
+}
+
+ValueTree ProxyManager::withProxyMedia (const ValueTree& tree) const
+{
+    return mapMedia (tree, false);
+}
+
+void ProxyManager::setFFmpegExecutable (const String& executable)
+{
+    ffmpegExecutable = executable;
+}
+
+//==============================================================================
+
+File ProxyManager::getProxyFile (const File& original) const
+{
+    // a changed original gets a new proxy
+    const auto key = original.getFullPathName() + ":" + String (original.getLastModificationTime().toMilliseconds());
+    return folder.getChildFile (String::toHexString (key.hashCode64()) + "_" + String (proxyHeight) + ".mov");
+}
+
+void ProxyManager::proxyFinished (const File& original, const File& proxy, bool success, const String& error)
+{
+    pending.erase (original.getFullPathName());
+
+    if (success)
+    {
+        for (int i = index.getNumChildren() - 1; i >= 0; --i)
+            if (index.getChild (i).getProperty (IDs::original).toString() == original.getFullPathName())
+                index.removeChild (i, nullptr);
+
+        ValueTree entry (IDs::proxy);
+        entry.setProperty (IDs::original, original.getFullPathName(), nullptr);
+        entry.setProperty (IDs::file, proxy.getFullPathName(), nullptr);
+        index.appendChild (entry, nullptr);
+        saveIndex();
+    }
+    else if (onProxyFailed)
+    {
+        onProxyFailed (original, error);
+    }
+
+    sendChangeMessage();
+}
+
+void ProxyManager::saveIndex()
+{
+    folder.createDirectory();
+
+    if (auto xml = std::unique_ptr<XmlElement> (index.createXml()))
+        xml->writeToFile (folder.getChildFile ("Proxies.xml"), {});
+}
+
+ValueTree ProxyManager::mapMedia (const ValueTree& tree, bool toOriginal) const
+{
+    auto copy = tree.createCopy();
+
+    // the media is referenced either as URL or as path
+    std::map<String, String> replacements;
+    for (const auto& entry : index)
+    {
+        const File original (entry.getProperty (IDs::original).toString());
+        const File proxy (entry.getProperty (IDs::file).toString());
+
+        if (toOriginal)
+        {
+            replacements [URL (proxy).toString (false)] = URL (original).toString (false);
+            replacements [proxy.getFullPathName()] = original.getFullPathName();
+        }
+        else if (isEnabled() && proxy.existsAsFile() && getProxyFile (original) == proxy)
+        {
+            replacements [URL (original).toString (false)] = URL (proxy).toString (false);
+            replacements [original.getFullPathName()] = proxy.getFullPathName();
+        }
+    }
+
+    if (replacements.empty())
+        return copy;
+
+    std::function<void(ValueTree)> replace = [&](ValueTree node)
+    {
+        for (int i = 0; i < node.getNumProperties(); ++i)
+        {
+            const auto name = node.getPropertyName (i);
+            const auto& value = node.getProperty (name);
+
+            if (value.isString())
+            {
+                auto it = replacements.find (value.toString());
+                if (it != replacements.end())
+                    node.setProperty (name, it->second, nullptr);
+            }
+        }
+
+        for (auto child : node)
+            replace (child);
+    };
+
+    replace (copy);
+    return copy;
+}
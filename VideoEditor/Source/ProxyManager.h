@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ProxyManager.h
+    Created: 17 Oct 2026 8:55:25pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    Creates low resolution intra-only proxies of the imported videos with the
+    ffmpeg executable and keeps track of them in the settings folder.
+
+    While proxies are enabled, clips are created from the proxy if there is
+    one, so the preview and the FilmStrips decode the small file. Edits are
+    always saved and rendered with the original media, the trees are mapped
+    between both with withOriginalMedia() and withProxyMedia().
+*/
+class ProxyManager  : public ChangeBroadcaster
+{
+public:
+    ProxyManager();
+    ~ProxyManager();
+
+    void setEnabled (bool shouldBeEnabled);
+    bool isEnabled() const;
+
+    /** Returns the proxy of the original media, or an empty URL if proxies are disabled or it doesn't exist yet */
+    URL getProxyFor (const URL& original) const;
+
+    /** Queues a transcode of the original, if proxies are enabled and there is none yet */
+    void requestProxy (const URL& original);
+
+    bool isCreatingProxies() const;
+
+    /** Returns a copy of the edit tree referring to the original media */
+    ValueTree withOriginalMedia (const ValueTree& tree) const;
+
+    /** Returns a copy of the edit tree referring to the existing proxies, or the original media if disabled */
+    ValueTree withProxyMedia (const ValueTree& tree) const;
+
+    /** Set the ffmpeg executable used for transcoding */
+    void setFFmpegExecutable (const String& executable);
+
+    /** The height of the proxies in pixels */
+    static constexpr int proxyHeight = 540;
+
+    /** Called on the message thread if a transcode failed, with the original and the error reported by ffmpeg */
+    std::function<void(const File& original, const String& error)> onProxyFailed;
+
+private:
+
+    class TranscodeJob;
+
+    File getProxyFile (const File& original) const;
+    void proxyFinished (const File& original, const File& proxy, bool success, const String& error);
+    void saveIndex();
+
+    ValueTree mapMedia (const ValueTree& tree, bool toOriginal) const;
+
+    File      folder;
+    ValueTree index;
+    String    ffmpegExecutable { "ffmpeg" };
+
+    std::set<String> pending;
+
+    ThreadPool threadPool { 1 };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (ProxyManager)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProxyManager)
+};
@@ -28,16 +28,79 @@
 #include "RenderDialog.h"
 
 //==============================================================================
-RenderDialog::RenderDialog (foleys::ClipRenderer& rendererToUse) : renderer (rendererToUse)
+RenderDialog::RenderDialog (SegmentRenderer& rendererToUse) : renderer (rendererToUse)
 {
+    addAndMakeVisible (presetSelect);
+    presetSelect.setEditableText (false);
+    presetSelect.onChange = [&]
+    {
+        selectPreset (presetSelect.getText());
+    };
+    savePreset.setConnectedEdges (TextButton::ConnectedOnRight);
+    deletePreset.setConnectedEdges (TextButton::ConnectedOnLeft);
+    addAndMakeVisible (savePreset);
+    addAndMakeVisible (deletePreset);
+    savePreset.onClick = [&] { saveAsPreset(); };
+    deletePreset.onClick = [&]
+    {
+        presets.removePreset (presetSelect.getText());
+        updatePresetList();
+    };
+
+    for (auto* label : { &width, &height })
+    {
+        label->setEditable (true);
+        label->setColour (Label::outlineColourId, Colours::silver);
+        label->setJustificationType (Justification::centred);
+        addAndMakeVisible (label);
+    }
+    width.onTextChange = [&]
+    {
+        settings.setProperty (RenderIDs::width, jmax (16, width.getText().getIntValue()), nullptr);
+        updateSettingsEditors();
+    };
+    height.onTextChange = [&]
+    {
+        settings.setProperty (RenderIDs::height, jmax (16, height.getText().getIntValue()), nullptr);
+        updateSettingsEditors();
+    };
+
+    for (const auto& rate : RenderPresets::frameRates)
+        frameRate.addItem (rate.name, frameRate.getNumItems() + 1);
+    frameRate.onChange = [&] { settings.setProperty (RenderIDs::frameRate, frameRate.getText(), nullptr); };
+
+    for (const auto& format : RenderPresets::pixelFormats)
+        pixelFormat.addItem (format.name, pixelFormat.getNumItems() + 1);
+    pixelFormat.onChange = [&] { settings.setProperty (RenderIDs::pixelFormat, pixelFormat.getText(), nullptr); };
+
+    for (auto rate : RenderPresets::sampleRates)
+        sampleRate.addItem (String (rate) + " Hz", rate);
+    sampleRate.onChange = [&] { settings.setProperty (RenderIDs::sampleRate, sampleRate.getSelectedId(), nullptr); };
+
+    numChannels.addItem (NEEDS_TRANS ("Mono"), 1);
+    numChannels.addItem (NEEDS_TRANS ("Stereo"), 2);
+    numChannels.onChange = [&] { settings.setProperty (RenderIDs::numChannels, numChannels.getSelectedId(), nullptr); };
+
+    for (auto* label : { &sizeLabel, &frameRateLabel, &pixelFormatLabel, &audioLabel })
+        addAndMakeVisible (label);
+
+    addAndMakeVisible (frameRate);
+    addAndMakeVisible (pixelFormat);
+    addAndMakeVisible (sampleRate);
+    addAndMakeVisible (numChannels);
+
     filename.setColour (Label::outlineColourId, Colours::silver);
     addAndMakeVisible (filename);
     browse.setConnectedEdges (TextButton::ConnectedOnLeft);
     addAndMakeVisible (browse);
     addAndMakeVisible (progressBar);
+    stats.setJustificationType (Justification::topLeft);
+    stats.setFont (Font (12.0f));
+    addAndMakeVisible (stats);
     addAndMakeVisible (cancel);
     addAndMakeVisible (start);
 
+    updatePresetList();
     updateGUI();
 
     start.onClick = [&]()
@@ -53,11 +116,9 @@ RenderDialog::RenderDialog (foleys::ClipRenderer& rendererToUse) : renderer (ren
                 return;
         }
 
-        foleys::VideoStreamSettings settings;
-        settings.frameSize = { 800, 576 };
-        renderer.setVideoSettings (settings);
-        renderer.startRendering (true);
-        startTimerHz (2);
+        renderer.setRenderSettings (settings);
+        if (renderer.startRendering())
+            startTimerHz (4);
     };
     cancel.onClick = [&]
     {
@@ -91,6 +152,31 @@ void RenderDialog::resized()
     auto bounds = getLocalBounds().reduced (5);
     auto w = bounds.getWidth() / 3;
 
+    auto p = bounds.removeFromTop (line).reduced (3);
+    deletePreset.setBounds (p.removeFromRight (w / 2));
+    savePreset.setBounds (p.removeFromRight (w / 2));
+    presetSelect.setBounds (p);
+
+    auto s = bounds.removeFromTop (line).reduced (3);
+    sizeLabel.setBounds (s.removeFromLeft (w));
+    width.setBounds (s.removeFromLeft (s.getWidth() / 2).withTrimmedRight (3));
+    height.setBounds (s.withTrimmedLeft (3));
+
+    auto r = bounds.removeFromTop (line).reduced (3);
+    frameRateLabel.setBounds (r.removeFromLeft (w));
+    frameRate.setBounds (r);
+
+    auto x = bounds.removeFromTop (line).reduced (3);
+    pixelFormatLabel.setBounds (x.removeFromLeft (w));
+    pixelFormat.setBounds (x);
+
+    auto a = bounds.removeFromTop (line).reduced (3);
+    audioLabel.setBounds (a.removeFromLeft (w));
+    sampleRate.setBounds (a.removeFromLeft (a.getWidth() / 2).withTrimmedRight (3));
+    numChannels.setBounds (a.withTrimmedLeft (3));
+
+    bounds.removeFromTop (line / 2);
+
     auto f = bounds.removeFromTop (line).reduced (3);
     browse.setBounds (f.removeFromRight (w));
     filename.setBounds (f);
@@ -100,6 +186,57 @@ void RenderDialog::resized()
     auto b = bounds.removeFromTop (line).reduced (3);
     cancel.setBounds (b.removeFromLeft (w));
     start.setBounds (b.removeFromRight (w));
+
+    stats.setBounds (bounds.removeFromTop (line * 3).reduced (3));
+}
+
+void RenderDialog::updatePresetList()
+{
+    presetSelect.clear (dontSendNotification);
+    presetSelect.addItemList (presets.getPresetNames(), 1);
+    selectPreset (presets.getSelectedPresetName());
+}
+
+void RenderDialog::selectPreset (const String& name)
+{
+    auto preset = presets.getPreset (name);
+    if (! preset.isValid())
+        preset = RenderPresets::createDefaultSettings();
+    else
+        presets.setSelectedPresetName (name);
+
+    settings = preset;
+    presetSelect.setText (name, dontSendNotification);
+    updateSettingsEditors();
+}
+
+void RenderDialog::saveAsPreset()
+{
+    AlertWindow dialog (NEEDS_TRANS ("Save Preset"), NEEDS_TRANS ("Enter a name for the render settings"), AlertWindow::QuestionIcon, this);
+    dialog.addTextEditor ("name", presetSelect.getText());
+    dialog.addButton (NEEDS_TRANS ("Save"), 1, KeyPress (KeyPress::returnKey));
+    dialog.addButton (NEEDS_TRANS ("Cancel"), 0, KeyPress (KeyPress::escapeKey));
+
+    if (dialog.runModalLoop() == 0)
+        return;
+
+    auto name = dialog.getTextEditorContents ("name").trim();
+    if (name.isEmpty())
+        return;
+
+    presets.savePreset (name, settings);
+    presets.setSelectedPresetName (name);
+    updatePresetList();
+}
+
+void RenderDialog::updateSettingsEditors()
+{
+    width.setText (settings.getProperty (RenderIDs::width).toString(), dontSendNotification);
+    height.setText (settings.getProperty (RenderIDs::height).toString(), dontSendNotification);
+    frameRate.setText (settings.getProperty (RenderIDs::frameRate).toString(), dontSendNotification);
+    pixelFormat.setText (settings.getProperty (RenderIDs::pixelFormat).toString(), dontSendNotification);
+    sampleRate.setSelectedId (settings.getProperty (RenderIDs::sampleRate), dontSendNotification);
+    numChannels.setSelectedId (settings.getProperty (RenderIDs::numChannels), dontSendNotification);
 }
 
 void RenderDialog::updateGUI()
@@ -110,7 +247,15 @@ void RenderDialog::updateGUI()
     cancel.setEnabled (rendering);
     start.setEnabled (! rendering);
 
-    progress = renderer.progress.load();
+    for (auto* component : std::initializer_list<Component*> { &presetSelect, &savePreset, &deletePreset, &width, &height,
+                                                               &frameRate, &pixelFormat, &sampleRate, &numChannels })
+        component->setEnabled (! rendering);
+
+    progress = renderer.getProgress();
+
+    const auto& renderStats = renderer.getStats();
+    if (rendering || renderStats.getProgress() > 0.0)
+        stats.setText (renderStats.getDescription(), dontSendNotification);
 }
 
 void RenderDialog::timerCallback()
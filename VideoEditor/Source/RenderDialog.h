@@ -27,6 +27,8 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "RenderPresets.h"
+#include "SegmentRenderer.h"
 
 //==============================================================================
 /*
@@ -35,7 +37,7 @@ class RenderDialog    : public Component,
                         private Timer
 {
 public:
-    RenderDialog (foleys::ClipRenderer& renderer);
+    RenderDialog (SegmentRenderer& renderer);
     ~RenderDialog();
 
 //    void paint (Graphics&) override;
@@ -46,13 +48,35 @@ public:
 private:
 
     void updateGUI();
-
-    foleys::ClipRenderer& renderer;
+    void updatePresetList();
+    void updateSettingsEditors();
+    void selectPreset (const String& name);
+    void saveAsPreset();
+
+    SegmentRenderer& renderer;
+    RenderPresets    presets;
+    ValueTree        settings;
+
+    ComboBox    presetSelect;
+    TextButton  savePreset   { NEEDS_TRANS ("Save") };
+    TextButton  deletePreset { NEEDS_TRANS ("Delete") };
+
+    Label       sizeLabel    { {}, NEEDS_TRANS ("Size") };
+    Label       width;
+    Label       height;
+    Label       frameRateLabel { {}, NEEDS_TRANS ("Frame rate") };
+    ComboBox    frameRate;
+    Label       pixelFormatLabel { {}, NEEDS_TRANS ("Pixels") };
+    ComboBox    pixelFormat;
+    Label       audioLabel   { {}, NEEDS_TRANS ("Audio") };
+    ComboBox    sampleRate;
+    ComboBox    numChannels;
 
     Label       filename;
     TextButton  browse { NEEDS_TRANS ("Browse") };
     double      progress = 0.0;
     ProgressBar progressBar { progress };
+    Label       stats;
     TextButton  cancel { NEEDS_TRANS ("Cancel") };
     TextButton  start  { NEEDS_TRANS ("Start") };
 
@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    RenderPresets.cpp
+    Created: 17 Oct 2026 8:33:16pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+#include "RenderPresets.h"
+
+//==============================================================================
+
+const std::vector<RenderPresets::FrameRate> RenderPresets::frameRates
+{
+    { "23.976", 24000, 1001 },
+    { "24",     24000, 1000 },
+    { "25",     25000, 1000 },
+    { "29.97",  30000, 1001 },
+    { "30",     30000, 1000 },
+    { "50",     50000, 1000 },
+    { "59.94",  60000, 1001 },
+    { "60",     60000, 1000 }
+};
+
+// values of AVPixelFormat, -1 lets the encoder choose
+const std::vector<RenderPresets::PixelFormat> RenderPresets::pixelFormats
+{
+    { "Default", -1 },
+    { "YUV 4:2:0", 0 },
+    { "YUV 4:2:2", 4 },
+    { "YUV 4:4:4", 5 }
+};
+
+const std::vector<int> RenderPresets::sampleRates { 44100, 48000, 96000 };
+
+//==============================================================================
+
+RenderPresets::RenderPresets()
+  : presetsFile (EditFile::getSettingsFolder().getChildFile ("RenderPresets.xml"))
+{
+    if (auto xml = XmlDocument::parse (presetsFile))
+        presets = ValueTree::fromXml (*xml);
+
+    if (! presets.hasType (RenderIDs::presets))
+        presets = ValueTree (RenderIDs::presets);
+
+    if (presets.getNumChildren() == 0)
+        addFactoryPresets();
+}
+
+StringArray RenderPresets::getPresetNames() const
+{
+    StringArray names;
+    for (const auto& preset : presets)
+        names.add (preset.getProperty (RenderIDs::name).toString());
+
+    return names;
+}
+
+ValueTree RenderPresets::getPreset (const String& name) const
+{
+    return presets.getChildWithProperty (RenderIDs::name, name).createCopy();
+}
+
+void RenderPresets::savePreset (const String& name, const ValueTree& settings)
+{
+    auto preset = settings.createCopy();
+    preset.setProperty (RenderIDs::name, name, nullptr);
+
+    auto existing = presets.getChildWithProperty (RenderIDs::name, name);
+    if (existing.isValid())
+        existing.copyPropertiesFrom (preset, nullptr);
+    else
+        presets.appendChild (preset, nullptr);
+
+    writePresets();
+}
+
+void RenderPresets::removePreset (const String& name)
+{
+    presets.removeChild (presets.getChildWithProperty (RenderIDs::name, name), nullptr);
+    writePresets();
+}
+
+String RenderPresets::getSelectedPresetName() const
+{
+    return presets.getProperty (RenderIDs::selected, getPresetNames() [0]);
+}
+
+void RenderPresets::setSelectedPresetName (const String& name)
+{
+    presets.setProperty (RenderIDs::selected, name, nullptr);
+    writePresets();
+}
+
+ValueTree RenderPresets::createDefaultSettings()
+{
+    return ValueTree (RenderIDs::preset, {
+        { RenderIDs::name,        "Default" },
+        { RenderIDs::width,       800 },
+        { RenderIDs::height,      576 },
+        { RenderIDs::frameRate,   "23.976" },
+        { RenderIDs::pixelFormat, "Default" },
+        { RenderIDs::sampleRate,  48000 },
+        { RenderIDs::numChannels, 2 }
+    });
+}
+
+void RenderPresets::addFactoryPresets()
+{
+    auto addPreset = [&](const String& name, int width, int height, const String& frameRate)
+    {
+        auto preset = createDefaultSettings();
+        preset.setProperty (RenderIDs::name, name, nullptr);
+        preset.setProperty (RenderIDs::width, width, nullptr);
+        preset.setProperty (RenderIDs::height, height, nullptr);
+        preset.setProperty (RenderIDs::frameRate, frameRate, nullptr);
+        presets.appendChild (preset, nullptr);
+    };
+
+    presets.appendChild (createDefaultSettings(), nullptr);
+    addPreset ("HD 720p 25",     1280,  720, "25");
+    addPreset ("HD 1080p 25",    1920, 1080, "25");
+    addPreset ("HD 1080p 29.97", 1920, 1080, "29.97");
+    addPreset ("UHD 2160p 25",   3840, 2160, "25");
+}
+
+void RenderPresets::writePresets()
+{
+    if (auto xml = presets.createXml())
+        if (! xml->writeTo (presetsFile))
+            DBG ("Writing render presets failed: " + presetsFile.getFullPathName());
+}
+
+//==============================================================================
+
+foleys::VideoStreamSettings RenderPresets::getVideoSettings (const ValueTree& settings)
+{
+    foleys::VideoStreamSettings video;
+    video.frameSize = { int (settings.getProperty (RenderIDs::width, 800)),
+                        int (settings.getProperty (RenderIDs::height, 576)) };
+
+    const auto frameRate = settings.getProperty (RenderIDs::frameRate).toString();
+    for (const auto& rate : frameRates)
+    {
+        if (frameRate == rate.name)
+        {
+            video.timebase = rate.timebase;
+            video.defaultDuration = rate.duration;
+        }
+    }
+
+    const auto pixelFormat = settings.getProperty (RenderIDs::pixelFormat).toString();
+    for (const auto& format : pixelFormats)
+        if (pixelFormat == format.name)
+            video.pixelFormat = format.format;
+
+    return video;
+}
+
+foleys::AudioStreamSettings RenderPresets::getAudioSettings (const ValueTree& settings)
+{
+    foleys::AudioStreamSettings audio;
+    audio.timebase    = settings.getProperty (RenderIDs::sampleRate, 48000);
+    audio.numChannels = settings.getProperty (RenderIDs::numChannels, 2);
+    return audio;
+}
+
+void RenderPresets::applyToRenderer (foleys::ClipRenderer& renderer, const ValueTree& settings)
+{
+    renderer.setVideoSettings (getVideoSettings (settings));
+    renderer.setAudioSettings (getAudioSettings (settings));
+}
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    RenderPresets.h
+    Created: 17 Oct 2026 8:33:16pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+namespace RenderIDs
+{
+    static const Identifier presets     { "RenderPresets" };
+    static const Identifier preset      { "Preset" };
+    static const Identifier selected    { "selected" };
+    static const Identifier name        { "name" };
+    static const Identifier width       { "width" };
+    static const Identifier height      { "height" };
+    static const Identifier frameRate   { "frameRate" };
+    static const Identifier pixelFormat { "pixelFormat" };
+    static const Identifier sampleRate  { "sampleRate" };
+    static const Identifier numChannels { "numChannels" };
+}
+
+//==============================================================================
+/*
+    Named output settings for the ClipRenderer. The presets are stored in the
+    settings folder next to the PluginList.xml.
+*/
+class RenderPresets
+{
+public:
+    RenderPresets();
+
+    StringArray getPresetNames() const;
+
+    /** Returns a copy of the preset with that name, or an invalid tree if it doesn't exist */
+    ValueTree getPreset (const String& name) const;
+
+    /** Adds or replaces the preset with that name and writes the presets file */
+    void savePreset (const String& name, const ValueTree& settings);
+
+    void removePreset (const String& name);
+
+    /** The preset that was used for the last render */
+    String getSelectedPresetName() const;
+    void setSelectedPresetName (const String& name);
+
+    /** Creates the settings the RenderDialog used before there were presets */
+    static ValueTree createDefaultSettings();
+
+    static foleys::VideoStreamSettings getVideoSettings (const ValueTree& settings);
+    static foleys::AudioStreamSettings getAudioSettings (const ValueTree& settings);
+
+    /** Configures the renderer to write the format of the settings in one pass */
+    static void applyToRenderer (foleys::ClipRenderer& renderer, const ValueTree& settings);
+
+    struct FrameRate
+    {
+        const char* name;
+        int timebase;
+        int duration;
+    };
+
+    struct PixelFormat
+    {
+        const char* name;
+        int format;
+    };
+
+    static const std::vector<FrameRate>   frameRates;
+    static const std::vector<PixelFormat> pixelFormats;
+    static const std::vector<int>         sampleRates;
+
+private:
+    void addFactoryPresets();
+    void writePresets();
+
+    File     presetsFile;
+    ValueTree presets;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderPresets)
+};
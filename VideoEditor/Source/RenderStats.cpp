@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    RenderStats.cpp
+    Created: 17 Oct 2026 8:36:39pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "RenderStats.h"
+
+//==============================================================================
+
+RenderStats::RenderStats()
+{
+    start (0.0, 0.0);
+}
+
+void RenderStats::start (double lengthInSeconds, double frameDurationInSeconds)
+{
+    startTime     = Time::getMillisecondCounterHiRes();
+    length        = lengthInSeconds;
+    frameDuration = frameDurationInSeconds;
+
+    progress.store (0.0);
+    elapsed.store (0.0);
+    framesPerSecond.store (0.0);
+    realtimeFactor.store (0.0);
+    remaining.store (0.0);
+
+    for (auto& seconds : phaseSeconds)
+        seconds.store (0.0);
+}
+
+void RenderStats::update (double newProgress)
+{
+    const auto seconds = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    progress.store (newProgress);
+    elapsed.store (seconds);
+
+    if (seconds <= 0.0 || newProgress <= 0.0)
+        return;
+
+    const auto rendered = newProgress * length;
+    framesPerSecond.store (frameDuration > 0.0 ? rendered / frameDuration / seconds : 0.0);
+    realtimeFactor.store (rendered / seconds);
+    remaining.store (seconds * (1.0 - newProgress) / newProgress);
+}
+
+void RenderStats::addPhaseTime (Phase phase, double seconds)
+{
+    auto& value = phaseSeconds [phase];
+    auto  current = value.load();
+    while (! value.compare_exchange_weak (current, current + seconds)) {}
+}
+
+double RenderStats::getPhaseSeconds (Phase phase) const
+{
+    return phaseSeconds [phase].load();
+}
+
+String RenderStats::getPhaseName (Phase phase)
+{
+    switch (phase)
+    {
+        case prepare:       return "prepare";
+        case render:        return "render";
+        case concatenate:   return "concatenate";
+        default:            return {};
+    }
+}
+
+String RenderStats::getDescription() const
+{
+    String text;
+    text << String (getFramesPerSecond(), 1) << " fps, "
+         << String (getRealtimeFactor(), 2) << "x realtime, "
+         << NEEDS_TRANS ("remaining") << ": " << RelativeTime (getRemainingSeconds()).getDescription();
+
+    for (int i = 0; i < numPhases; ++i)
+        if (getPhaseSeconds (Phase (i)) > 0.0)
+            text << "\n" << getPhaseName (Phase (i)) << ": " << String (getPhaseSeconds (Phase (i)), 2) << " s";
+
+    return text;
+}
+
+String RenderStats::toJsonLine() const
+{
+    auto* object = new DynamicObject();
+    object->setProperty ("time", Time::getCurrentTime().toISO8601 (true));
+    object->setProperty ("progress", getProgress());
+    object->setProperty ("elapsed", getElapsedSeconds());
+    object->setProperty ("fps", getFramesPerSecond());
+    object->setProperty ("realtime", getRealtimeFactor());
+    object->setProperty ("eta", getRemainingSeconds());
+
+    auto* phases = new DynamicObject();
+    for (int i = 0; i < numPhases; ++i)
+        phases->setProperty (getPhaseName (Phase (i)), getPhaseSeconds (Phase (i)));
+
+    object->setProperty ("phases", var (phases));
+
+    return JSON::toString (var (object), true);
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    RenderStats.h
+    Created: 17 Oct 2026 8:36:39pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    Throughput figures of a running render. The renderer writes them and any
+    other thread can read them at any time, all values are lock free atomics.
+
+    The times are measured per phase of the job, not per stage of the
+    pipeline: decoding, compositing, the processors and encoding all run
+    inside the engine's ClipRenderer, which doesn't report them separately.
+*/
+class RenderStats
+{
+public:
+    enum Phase
+    {
+        prepare = 0,    // creating the copies of the edit
+        render,         // the ClipRenderers, from the first to the last segment finished
+        concatenate,    // joining the segments into the output file
+        numPhases
+    };
+
+    RenderStats();
+
+    /** Resets all figures for a new job */
+    void start (double lengthInSeconds, double frameDurationInSeconds);
+
+    /** Recalculates the figures from the progress between 0 and 1 */
+    void update (double progress);
+
+    void addPhaseTime (Phase phase, double seconds);
+
+    double getProgress() const          { return progress.load(); }
+    double getElapsedSeconds() const    { return elapsed.load(); }
+    double getFramesPerSecond() const   { return framesPerSecond.load(); }
+    double getRealtimeFactor() const    { return realtimeFactor.load(); }
+    double getRemainingSeconds() const  { return remaining.load(); }
+    double getPhaseSeconds (Phase phase) const;
+
+    static String getPhaseName (Phase phase);
+
+    /** Returns a human readable description for the RenderDialog */
+    String getDescription() const;
+
+    /** Returns the figures as JSON on a single line, to append to a log file */
+    String toJsonLine() const;
+
+private:
+    double startTime     = 0.0;
+    double length        = 0.0;
+    double frameDuration = 0.0;
+
+    std::atomic<double> progress        { 0.0 };
+    std::atomic<double> elapsed         { 0.0 };
+    std::atomic<double> framesPerSecond { 0.0 };
+    std::atomic<double> realtimeFactor  { 0.0 };
+    std::atomic<double> remaining       { 0.0 };
+
+    std::atomic<double> phaseSeconds [numPhases];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderStats)
+};
@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    SeekIndex.cpp
+    Created: 17 Oct 2026 9:00:05pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+#include "SeekIndex.h"
+
+//==============================================================================
+/*
+    Reads the index file, or runs ffprobe over the packets of the first video
+    stream and writes the file: int32 numKeyframes, numKeyframes doubles.
+*/
+class SeekIndex::IndexJob  : public ThreadPoolJob
+{
+public:
+    IndexJob (SeekIndex& owner, const String& ffprobe, const File& mediaToUse, const File& indexToUse)
+      : ThreadPoolJob ("Seek index " + mediaToUse.getFileName()),
+        seekIndex (owner),
+        executable (ffprobe),
+        media (mediaToUse),
+        indexFile (indexToUse)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto keyframes = readIndex();
+
+        if (keyframes.empty() && ! shouldExit())
+        {
+            keyframes = probe();
+
+            if (! keyframes.empty())
+                writeIndex (keyframes);
+        }
+
+        seekIndex.indexFinished (media.getFullPathName(), std::move (keyframes));
+        return jobHasFinished;
+    }
+
+private:
+    std::vector<double> readIndex() const
+    {
+        std::vector<double> keyframes;
+
+        FileInputStream input (indexFile);
+        if (! input.openedOk())
+            return keyframes;
+
+        const auto numKeyframes = input.readInt();
+        if (numKeyframes <= 0 || input.getNumBytesRemaining() != numKeyframes * int64 (sizeof (double)))
+            return keyframes;
+
+        keyframes.resize (size_t (numKeyframes));
+        for (auto& keyframe : keyframes)
+            keyframe = input.readDouble();
+
+        return keyframes;
+    }
+
+    void writeIndex (const std::vector<double>& keyframes) const
+    {
+        TemporaryFile temp (indexFile);
+
+        {
+            FileOutputStream output (temp.getFile());
+            if (! output.openedOk())
+                return;
+
+            output.writeInt (int (keyframes.size()));
+            for (auto keyframe : keyframes)
+                output.writeDouble (keyframe);
+        }
+
+        temp.overwriteTargetFileWithTemporary();
+    }
+
+    std::vector<double> probe()
+    {
+        // reading the packet flags needs no decoding
+        StringArray command { executable, "-v", "error",
+                              "-select_streams", "v:0",
+                              "-show_entries", "packet=pts_time,flags",
+                              "-of", "csv=p=0",
+                              media.getFullPathName() };
+
+        ChildProcess process;
+        if (! process.start (command, ChildProcess::wantStdOut))
+            return {};
+
+        MemoryOutputStream output;
+        char buffer [4096];
+
+        for (;;)
+        {
+            if (shouldExit())
+            {
+                process.kill();
+                return {};
+            }
+
+            const auto numRead = process.readProcessOutput (buffer, sizeof (buffer));
+            if (numRead <= 0)
+                break;
+
+            output.write (buffer, size_t (numRead));
+        }
+
+        if (process.getExitCode() != 0)
+            return {};
+
+        std::vector<double> keyframes;
+
+        for (const auto& line : StringArray::fromLines (output.toString()))
+        {
+            const auto pts   = line.upToFirstOccurrenceOf (",", false, false);
+            const auto flags = line.fromFirstOccurrenceOf (",", false, false);
+
+            if (flags.containsChar ('K') && pts.containsAnyOf ("0123456789"))
+                keyframes.push_back (pts.getDoubleValue());
+        }
+
+        // packets are stored in decoding order
+        std::sort (keyframes.begin(), keyframes.end());
+        return keyframes;
+    }
+
+    SeekIndex& seekIndex;
+    const String executable;
+    const File media;
+    const File indexFile;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IndexJob)
+};
+
+//==============================================================================
+
+SeekIndex::SeekIndex()
+  : folder (EditFile::getSettingsFolder().getChildFile ("SeekIndex"))
+{
+    folder.createDirectory();
+}
+
+SeekIndex::~SeekIndex()
+{
+    threadPool.removeAllJobs (true, 5000);
+}
+
+void SeekIndex::requestIndex (const URL& media)
+{
+    if (! media.isLocalFile())
+        return;
+
+    const auto file = media.getLocalFile();
+
+    {
+        const ScopedLock sl (lock);
+        if (indices.find (file.getFullPathName()) != indices.end() || ! pending.insert (file.getFullPathName()).second)
+            return;
+    }
+
+    threadPool.addJob (new IndexJob (*this, ffprobeExecutable, file, getIndexFile (file)), true);
+}
+
+double SeekIndex::getKeyframeBefore (const URL& media, double seconds) const
+{
+    if (! media.isLocalFile())
+        return seconds;
+
+    const ScopedLock sl (lock);
+
+    auto it = indices.find (media.getLocalFile().getFullPathName());
+    if (it == indices.end() || it->second.empty())
+        return seconds;
+
+    const auto& keyframes = it->second;
+    auto next = std::upper_bound (keyframes.begin(), keyframes.end(), seconds + 0.0001);
+    return next == keyframes.begin() ? keyframes.front() : *std::prev (next);
+}
+
+bool SeekIndex::isIndexed (const URL& media) const
+{
+    if (! media.isLocalFile())
+        return false;
+
+    const ScopedLock sl (lock);
+    return indices.find (media.getLocalFile().getFullPathName()) != indices.end();
+}
+
+void SeekIndex::setFFprobeExecutable (const String& executable)
+{
+    ffprobeExecutable = executable;
+}
+
+//==============================================================================
+
+File SeekIndex::getIndexFile (const File& media) const
+{
+    // a changed file gets a new index
+    const auto key = media.getFullPathName() + ":" + String (media.getLastModificationTime().toMilliseconds());
+    return folder.getChildFile (String::toHexString (key.hashCode64()) + ".keys");
+}
+
+void SeekIndex::indexFinished (const String& path, std::vector<double> keyframes)
+{
+    const ScopedLock sl (lock);
+    pending.erase (path);
+
+    // a file without an index is not probed again in this session
+    indices [path] = std::move (keyframes);
+}
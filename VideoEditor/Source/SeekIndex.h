@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    SeekIndex.h
+    Created: 17 Oct 2026 9:00:05pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    Keeps the keyframe timestamps of the video files. The index of a file is
+    read once with ffprobe and stored in the settings folder, so scrubbing can
+    start decoding at the closest keyframe without searching for it again.
+*/
+class SeekIndex
+{
+public:
+    SeekIndex();
+    ~SeekIndex();
+
+    /** Loads the index of the media from disk or builds it in the background, returns immediately */
+    void requestIndex (const URL& media);
+
+    /** Returns the last keyframe at or before seconds, or seconds if the media is not indexed (yet) */
+    double getKeyframeBefore (const URL& media, double seconds) const;
+
+    bool isIndexed (const URL& media) const;
+
+    /** Set the ffprobe executable used for indexing */
+    void setFFprobeExecutable (const String& executable);
+
+private:
+
+    class IndexJob;
+
+    File getIndexFile (const File& media) const;
+    void indexFinished (const String& path, std::vector<double> keyframes);
+
+    File   folder;
+    String ffprobeExecutable { "ffprobe" };
+
+    mutable CriticalSection lock;
+    std::map<String, std::vector<double>> indices;
+    std::set<String> pending;
+
+    ThreadPool threadPool { 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SeekIndex)
+};
@@ -0,0 +1,425 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    SegmentRenderer.cpp
+    Created: 17 Oct 2026 8:34:49pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+#include "RenderPresets.h"
+#include "SegmentRenderer.h"
+
+namespace IDs
+{
+    // the properties of the clips in the edit, as written by the engine
+    static Identifier start  { "start" };
+    static Identifier length { "length" };
+    static Identifier offset { "offset" };
+}
+
+//==============================================================================
+/*
+    Joins the segments with ffmpeg. The job is owned by the SegmentRenderer,
+    which removes it from the pool on cancel, and the process is killed.
+*/
+class SegmentRenderer::ConcatJob  : public ThreadPoolJob
+{
+public:
+    ConcatJob (SegmentRenderer& owner, const StringArray& commandToRun)
+      : ThreadPoolJob ("Concatenate segments"),
+        renderer (&owner),
+        generation (owner.runGeneration),
+        command (commandToRun)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        const auto startTime = Time::getMillisecondCounterHiRes();
+
+        ChildProcess process;
+        if (! process.start (command))
+            return finish (false, 0.0);
+
+        while (process.isRunning())
+        {
+            if (shouldExit())
+            {
+                process.kill();
+                return jobHasFinished;
+            }
+
+            Thread::sleep (50);
+        }
+
+        return finish (process.getExitCode() == 0, (Time::getMillisecondCounterHiRes() - startTime) / 1000.0);
+    }
+
+private:
+    JobStatus finish (bool success, double seconds)
+    {
+        // the stats are only touched on the message thread, where the renderer is known to be alive
+        MessageManager::callAsync ([renderer = renderer, generation = generation, success, seconds]
+        {
+            if (renderer == nullptr || ! renderer->rendering || renderer->runGeneration != generation)
+                return;
+
+            renderer->stats.addPhaseTime (RenderStats::concatenate, seconds);
+            renderer->finish (success);
+        });
+
+        return jobHasFinished;
+    }
+
+    WeakReference<SegmentRenderer> renderer;
+    const int generation;
+    const StringArray command;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConcatJob)
+};
+
+//==============================================================================
+SegmentRenderer::SegmentRenderer (foleys::VideoEngine& videoEngineToUse)
+  : videoEngine (videoEngineToUse),
+    settings (RenderPresets::createDefaultSettings())
+{
+}
+
+SegmentRenderer::~SegmentRenderer()
+{
+    onRenderingFinished = nullptr;
+    cancelRendering();
+}
+
+void SegmentRenderer::setClipToRender (std::shared_ptr<foleys::ComposedClip> editToRender)
+{
+    jassert (! rendering);
+    edit = editToRender;
+}
+
+void SegmentRenderer::setOutputFile (const File& file)
+{
+    outputFile = file;
+}
+
+File SegmentRenderer::getOutputFile() const
+{
+    return outputFile;
+}
+
+void SegmentRenderer::setRenderSettings (const ValueTree& settingsToUse)
+{
+    settings = settingsToUse.createCopy();
+}
+
+void SegmentRenderer::setNumSegments (int numSegments)
+{
+    numSegmentsToUse = jmax (0, numSegments);
+}
+
+void SegmentRenderer::setFFmpegExecutable (const String& executable)
+{
+    ffmpegExecutable = executable;
+}
+
+bool SegmentRenderer::startRendering()
+{
+    if (rendering || edit == nullptr || outputFile == File())
+        return false;
+
+    const auto cutPoints = findCutPoints (numSegmentsToUse > 0 ? numSegmentsToUse : SystemStats::getNumCpus());
+    const auto length    = edit->getLengthInSeconds();
+    const auto numParts  = int (cutPoints.size());
+
+    const auto prepareStartTime = Time::getMillisecondCounterHiRes();
+    const auto generation = ++runGeneration;
+    stats.start (length, getFrameDuration());
+    segments.clear();
+
+    for (int i = 0; i < numParts; ++i)
+    {
+        auto segment = std::make_unique<Segment>();
+        segment->start = cutPoints [size_t (i)];
+        segment->end   = i + 1 < numParts ? cutPoints [size_t (i + 1)] : length;
+
+        if (numParts == 1)
+        {
+            segment->file = outputFile;
+            segment->clip = edit;
+        }
+        else
+        {
+            segment->file = outputFile.getSiblingFile (outputFile.getFileNameWithoutExtension() + ".part" + String (i) + outputFile.getFileExtension());
+            segment->clip = createSegmentClip (segment->start, segment->end);
+        }
+
+        if (segment->clip == nullptr)
+            return false;
+
+        segment->file.deleteFile();
+
+        segment->renderer = std::make_unique<foleys::ClipRenderer>(videoEngine);
+        segment->renderer->setClipToRender (segment->clip);
+        segment->renderer->setOutputFile (segment->file);
+        RenderPresets::applyToRenderer (*segment->renderer, settings);
+        segment->renderer->onRenderingFinished = [self = WeakReference<SegmentRenderer> (this), generation, s = segment.get()](bool success)
+        {
+            MessageManager::callAsync ([self, generation, s, success]
+            {
+                if (self != nullptr)
+                    self->segmentFinished (generation, s, success);
+            });
+        };
+
+        segments.push_back (std::move (segment));
+    }
+
+    rendering = true;
+    renderStartTime = Time::getMillisecondCounterHiRes();
+    stats.addPhaseTime (RenderStats::prepare, (renderStartTime - prepareStartTime) / 1000.0);
+
+    for (auto& segment : segments)
+        segment->renderer->startRendering (true);
+
+    startTimerHz (4);
+    return true;
+}
+
+void SegmentRenderer::cancelRendering()
+{
+    if (! rendering)
+        return;
+
+    for (auto& segment : segments)
+        if (segment->renderer->isRendering())
+            segment->renderer->cancelRendering();
+
+    finish (false);
+}
+
+bool SegmentRenderer::isRendering() const
+{
+    return rendering;
+}
+
+const RenderStats& SegmentRenderer::getStats() const
+{
+    return stats;
+}
+
+double SegmentRenderer::getProgress() const
+{
+    auto total = 0.0;
+    auto done  = 0.0;
+
+    for (const auto& segment : segments)
+    {
+        const auto length = segment->end - segment->start;
+        total += length;
+        done  += length * (segment->finished ? 1.0 : segment->renderer->progress.load());
+    }
+
+    return total > 0.0 ? done / total : 0.0;
+}
+
+int SegmentRenderer::getNumActiveSegments() const
+{
+    return int (segments.size());
+}
+
+//==============================================================================
+
+double SegmentRenderer::getFrameDuration() const
+{
+    const auto video = RenderPresets::getVideoSettings (settings);
+    return video.timebase > 0 ? double (video.defaultDuration) / video.timebase : 1.0 / 25.0;
+}
+
+void SegmentRenderer::timerCallback()
+{
+    stats.update (getProgress());
+}
+
+bool SegmentRenderer::isCoveredByClip (double time) const
+{
+    const auto frame = getFrameDuration();
+
+    for (const auto& descriptor : edit->getClips())
+    {
+        const auto start = descriptor->getStart();
+        if (start < time - frame && start + descriptor->getLength() > time + frame)
+            return true;
+    }
+
+    return false;
+}
+
+std::vector<double> SegmentRenderer::findCutPoints (int numSegments) const
+{
+    std::vector<double> cutPoints { 0.0 };
+
+    if (edit == nullptr)
+        return cutPoints;
+
+    const auto frame  = getFrameDuration();
+    const auto length = edit->getLengthInSeconds();
+    const auto clips  = edit->getClips();
+
+    // A segment is only as long as its last clip, so a cut inside a gap would
+    // swallow the gap. Those cuts move forward into the next clip.
+    auto findCoveredCut = [&](double time)
+    {
+        if (isCoveredByClip (time))
+            return time;
+
+        auto best = length;
+        for (const auto& descriptor : clips)
+        {
+            const auto candidate = std::ceil ((descriptor->getStart() + frame) / frame) * frame;
+            if (candidate > time && candidate < best && isCoveredByClip (candidate))
+                best = candidate;
+        }
+
+        return best;
+    };
+
+    for (int i = 1; i < numSegments; ++i)
+    {
+        const auto target = std::round (length * i / numSegments / frame) * frame;
+        const auto cut = findCoveredCut (target);
+
+        if (cut > cutPoints.back() + frame && cut < length - frame)
+            cutPoints.push_back (cut);
+    }
+
+    return cutPoints;
+}
+
+std::shared_ptr<foleys::ComposedClip> SegmentRenderer::createSegmentClip (double start, double end)
+{
+    // The clips are trimmed in a copy of the tree without an UndoManager, so
+    // the user's undo history doesn't see the segments.
+    edit->readPluginStatesIntoValueTree();
+    auto tree = edit->getStatusTree().createCopy();
+
+    for (int i = tree.getNumChildren() - 1; i >= 0; --i)
+    {
+        auto clip = tree.getChild (i);
+        const auto clipStart = double (clip.getProperty (IDs::start));
+        const auto clipEnd   = clipStart + double (clip.getProperty (IDs::length));
+
+        if (clipEnd <= start || clipStart >= end)
+        {
+            tree.removeChild (i, nullptr);
+            continue;
+        }
+
+        // the automation is in clip time, so moving the offset keeps it in place
+        clip.setProperty (IDs::offset, double (clip.getProperty (IDs::offset)) + jmax (start - clipStart, 0.0), nullptr);
+        clip.setProperty (IDs::start, jmax (clipStart - start, 0.0), nullptr);
+        clip.setProperty (IDs::length, jmin (clipEnd, end) - jmax (clipStart, start), nullptr);
+    }
+
+    return EditFile::createEdit (videoEngine, tree);
+}
+
+void SegmentRenderer::segmentFinished (int generation, Segment* segment, bool success)
+{
+    // a new Segment can live at the address of one from a previous run
+    if (! rendering || generation != runGeneration)
+        return;
+
+    auto it = std::find_if (segments.begin(), segments.end(), [segment](const auto& s) { return s.get() == segment; });
+    if (it == segments.end())
+        return;
+
+    segment->finished = true;
+    segment->success  = success;
+
+    if (! success)
+    {
+        cancelRendering();
+        return;
+    }
+
+    if (std::all_of (segments.begin(), segments.end(), [](const auto& s) { return s->finished; }))
+    {
+        stats.addPhaseTime (RenderStats::render, (Time::getMillisecondCounterHiRes() - renderStartTime) / 1000.0);
+
+        if (segments.size() == 1)
+            finish (true);
+        else
+            concatenateSegments();
+    }
+}
+
+void SegmentRenderer::concatenateSegments()
+{
+    auto listFile = outputFile.getSiblingFile (outputFile.getFileNameWithoutExtension() + ".parts.txt");
+
+    String list;
+    for (const auto& segment : segments)
+        list << "file '" << segment->file.getFullPathName().replace ("'", "'\\''") << "'\n";
+
+    if (! listFile.replaceWithText (list))
+    {
+        finish (false);
+        return;
+    }
+
+    outputFile.deleteFile();
+
+    StringArray command { ffmpegExecutable, "-y", "-loglevel", "error",
+                          "-f", "concat", "-safe", "0", "-i", listFile.getFullPathName(),
+                          "-c", "copy", outputFile.getFullPathName() };
+
+    concatJob = std::make_unique<ConcatJob>(*this, command);
+    videoEngine.getThreadPool().addJob (concatJob.get(), false);
+}
+
+void SegmentRenderer::finish (bool success)
+{
+    stopTimer();
+    stats.update (success ? 1.0 : getProgress());
+    rendering = false;
+
+    // a cancelled join kills ffmpeg before its inputs are deleted
+    if (concatJob != nullptr)
+    {
+        videoEngine.getThreadPool().removeJob (concatJob.get(), true, -1);
+        concatJob.reset();
+    }
+
+    if (segments.size() > 1)
+    {
+        for (const auto& segment : segments)
+            segment->file.deleteFile();
+
+        outputFile.getSiblingFile (outputFile.getFileNameWithoutExtension() + ".parts.txt").deleteFile();
+    }
+
+    segments.clear();
+
+    if (onRenderingFinished)
+        onRenderingFinished (success);
+}
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    SegmentRenderer.h
+    Created: 17 Oct 2026 8:34:49pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "RenderStats.h"
+
+//==============================================================================
+/*
+    Renders an edit in several segments in parallel, each one with its own
+    ClipRenderer on a copy of the edit. The segments start at frame aligned
+    cut points, so each segment starts with a key frame, and they are joined
+    with the ffmpeg concat demuxer without re-encoding.
+
+    With one segment, the default, the edit is rendered directly into the
+    output file and no ffmpeg executable is needed.
+*/
+class SegmentRenderer  : private Timer
+{
+public:
+    SegmentRenderer (foleys::VideoEngine& videoEngine);
+    ~SegmentRenderer();
+
+    void setClipToRender (std::shared_ptr<foleys::ComposedClip> edit);
+
+    void setOutputFile (const File& file);
+    File getOutputFile() const;
+
+    /** The render settings as created by the RenderPresets */
+    void setRenderSettings (const ValueTree& settings);
+
+    /** Set the number of segments to render in parallel, 0 uses one per CPU core. The default is 1. */
+    void setNumSegments (int numSegments);
+
+    /** Set the ffmpeg executable used for joining the segments */
+    void setFFmpegExecutable (const String& executable);
+
+    bool startRendering();
+    void cancelRendering();
+    bool isRendering() const;
+
+    /** Returns the progress of all segments between 0 and 1 */
+    double getProgress() const;
+
+    /** Returns the throughput figures of the current or last job */
+    const RenderStats& getStats() const;
+
+    /** Returns the number of segments of the current job, may be less than requested */
+    int getNumActiveSegments() const;
+
+    /** Returns the frame aligned start times of the segments */
+    std::vector<double> findCutPoints (int numSegments) const;
+
+    /** Returns the duration of one output frame in seconds */
+    double getFrameDuration() const;
+
+    /** Called on the message thread when the job has finished */
+    std::function<void(bool success)> onRenderingFinished;
+
+private:
+
+    struct Segment
+    {
+        double start = 0.0;
+        double end   = 0.0;
+        File   file;
+        std::shared_ptr<foleys::ComposedClip> clip;
+        std::unique_ptr<foleys::ClipRenderer> renderer;
+        bool   finished = false;
+        bool   success  = false;
+    };
+
+    class ConcatJob;
+
+    void timerCallback() override;
+
+    bool isCoveredByClip (double time) const;
+
+    std::shared_ptr<foleys::ComposedClip> createSegmentClip (double start, double end);
+    /** Callbacks of a previous run carry an older generation and are ignored */
+    void segmentFinished (int generation, Segment* segment, bool success);
+    void concatenateSegments();
+    void finish (bool success);
+
+    foleys::VideoEngine& videoEngine;
+
+    std::shared_ptr<foleys::ComposedClip> edit;
+    File      outputFile;
+    ValueTree settings;
+    int       numSegmentsToUse = 1;
+    String    ffmpegExecutable { "ffmpeg" };
+
+    std::vector<std::unique_ptr<Segment>> segments;
+    std::unique_ptr<ConcatJob> concatJob;
+    bool rendering = false;
+    int  runGeneration = 0;
+
+    RenderStats stats;
+    double renderStartTime = 0.0;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (SegmentRenderer)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SegmentRenderer)
+};
@@ -0,0 +1,307 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ThumbnailCache.cpp
+    Created: 17 Oct 2026 8:43:53pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "EditFile.h"
+#include "ThumbnailCache.h"
+
+//==============================================================================
+/*
+    Append only file of records: int64 millis, int32 numBytes, JPEG data.
+    A record cut short by a crash is ignored when the file is scanned.
+
+    The lock only guards the index and the mapping, the writers are serialised
+    by their own lock, so reading a tile never waits for the disk.
+*/
+class ThumbnailCache::TileFile
+{
+public:
+    TileFile (const File& fileToUse) : file (fileToUse) {}
+
+    /** Returns the JPEG data of the tile, or an empty block */
+    MemoryBlock read (int64 millis)
+    {
+        scanIfNeeded();
+
+        const ScopedLock sl (lock);
+
+        auto it = index.find (millis);
+        if (it == index.end())
+            return {};
+
+        if (mapped == nullptr || mapped->getRange().getEnd() < it->second.getEnd())
+            mapped = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readOnly);
+
+        if (mapped->getData() == nullptr || mapped->getRange().getEnd() < it->second.getEnd())
+            return {};
+
+        return MemoryBlock (addBytesToPointer (mapped->getData(), it->second.getStart()), size_t (it->second.getLength()));
+    }
+
+    void write (int64 millis, const MemoryBlock& jpeg)
+    {
+        scanIfNeeded();
+
+        const ScopedLock sl (writeLock);
+
+        FileOutputStream output (file);
+        if (! output.openedOk())
+            return;
+
+        // drop a broken record from a previous crash
+        output.setPosition (validSize);
+        output.truncate();
+
+        output.writeInt64 (millis);
+        output.writeInt (int (jpeg.getSize()));
+        const auto position = output.getPosition();
+        output.write (jpeg.getData(), jpeg.getSize());
+        output.flush();
+
+        if (output.getStatus().wasOk())
+        {
+            validSize = output.getPosition();
+
+            const ScopedLock indexLock (lock);
+            index [millis] = { position, validSize };
+        }
+    }
+
+private:
+    /** The file is scanned on first use and not when it's created under the cache's lock */
+    void scanIfNeeded()
+    {
+        if (scanned.load())
+            return;
+
+        const ScopedLock sl (writeLock);
+        if (scanned.load())
+            return;
+
+        FileInputStream input (file);
+
+        while (input.openedOk() && input.getNumBytesRemaining() >= 12)
+        {
+            const auto millis   = input.readInt64();
+            const auto numBytes = input.readInt();
+            const auto position = input.getPosition();
+
+            if (numBytes <= 0 || position + numBytes > input.getTotalLength())
+                break;
+
+            {
+                const ScopedLock indexLock (lock);
+                index [millis] = { position, position + numBytes };
+            }
+
+            input.setPosition (position + numBytes);
+            validSize = position + numBytes;
+        }
+
+        scanned.store (true);
+    }
+
+    File file;
+    std::atomic<bool> scanned { false };
+
+    CriticalSection lock;
+    std::unique_ptr<MemoryMappedFile> mapped;
+    std::map<int64, Range<int64>> index;
+
+    CriticalSection writeLock;
+    int64 validSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TileFile)
+};
+
+//==============================================================================
+
+ThumbnailCache::ThumbnailCache()
+  : folder (EditFile::getSettingsFolder().getChildFile ("Thumbnails"))
+{
+    folder.createDirectory();
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    threadPool.removeAllJobs (true, 1000);
+}
+
+String ThumbnailCache::getMediaId (const foleys::AVClip& clip)
+{
+    const auto url = clip.getMediaFile();
+    if (url.isEmpty())
+        return "clip:" + String::toHexString (pointer_sized_int (&clip));
+
+    // a changed file needs new thumbnails
+    if (url.isLocalFile())
+        return url.toString (false) + "@" + String (url.getLocalFile().getLastModificationTime().toMilliseconds());
+
+    return url.toString (false);
+}
+
+bool ThumbnailCache::isPersistent (const String& mediaId)
+{
+    return ! mediaId.startsWith ("clip:");
+}
+
+String ThumbnailCache::getKey (const String& mediaId, int64 millis, int height)
+{
+    return mediaId + ":" + String (millis) + ":" + String (height);
+}
+
+Image ThumbnailCache::getMemoryThumbnail (const String& mediaId, int64 millis, int height)
+{
+    if (mediaId.isEmpty())
+        return {};
+
+    const ScopedLock sl (lock);
+
+    auto it = memoryLookup.find (getKey (mediaId, millis, height));
+    if (it == memoryLookup.end())
+        return {};
+
+    memory.splice (memory.begin(), memory, it->second);
+    return it->second->image;
+}
+
+Image ThumbnailCache::getCachedThumbnail (const String& mediaId, int64 millis, int height)
+{
+    if (mediaId.isEmpty())
+        return {};
+
+    const auto key = getKey (mediaId, millis, height);
+
+    TileFile* tiles = nullptr;
+    {
+        const ScopedLock sl (lock);
+
+        auto it = memoryLookup.find (key);
+        if (it != memoryLookup.end())
+        {
+            memory.splice (memory.begin(), memory, it->second);
+            return it->second->image;
+        }
+
+        if (isPersistent (mediaId))
+            tiles = getTileFile (mediaId, height);
+    }
+
+    if (tiles == nullptr)
+        return {};
+
+    // decoding doesn't hold the lock, so the workers keep adding thumbnails meanwhile
+    const auto jpeg = tiles->read (millis);
+    if (jpeg.getSize() == 0)
+        return {};
+
+    MemoryInputStream stream (jpeg, false);
+    auto image = JPEGImageFormat().decodeImage (stream);
+
+    if (image.isValid())
+    {
+        const ScopedLock sl (lock);
+        addToMemory (key, image);
+    }
+
+    return image;
+}
+
+Image ThumbnailCache::getThumbnail (foleys::AVClip& clip, const String& mediaId, int64 millis, int height)
+{
+    auto image = getCachedThumbnail (mediaId, millis, height);
+    if (image.isValid())
+        return image;
+
+    const auto videoSize = clip.getVideoSize();
+    const auto width = videoSize.height > 0 ? roundToInt (height * videoSize.width / double (videoSize.height)) : height * 16 / 9;
+
+    image = clip.getStillImage (millis / 1000.0, { width, height });
+    if (! image.isValid() || mediaId.isEmpty())
+        return image;
+
+    TileFile* tiles = nullptr;
+    {
+        const ScopedLock sl (lock);
+        addToMemory (getKey (mediaId, millis, height), image);
+
+        if (isPersistent (mediaId))
+            tiles = getTileFile (mediaId, height);
+    }
+
+    if (tiles != nullptr)
+    {
+        MemoryOutputStream jpeg;
+        JPEGImageFormat format;
+        format.setQuality (0.8f);
+
+        if (format.writeImageToStream (image, jpeg))
+            tiles->write (millis, jpeg.getMemoryBlock());
+    }
+
+    return image;
+}
+
+void ThumbnailCache::setMemoryBudget (size_t bytes)
+{
+    const ScopedLock sl (lock);
+    memoryBudget = bytes;
+    addToMemory ({}, {});
+}
+
+ThreadPool& ThumbnailCache::getThreadPool()
+{
+    return threadPool;
+}
+
+void ThumbnailCache::addToMemory (const String& key, const Image& image)
+{
+    if (image.isValid() && memoryLookup.find (key) == memoryLookup.end())
+    {
+        const auto bytes = size_t (image.getWidth() * image.getHeight() * 4);
+        memory.push_front ({ key, image, bytes });
+        memoryLookup [key] = memory.begin();
+        memoryUsed += bytes;
+    }
+
+    while (memoryUsed > memoryBudget && ! memory.empty())
+    {
+        memoryUsed -= memory.back().bytes;
+        memoryLookup.erase (memory.back().key);
+        memory.pop_back();
+    }
+}
+
+ThumbnailCache::TileFile* ThumbnailCache::getTileFile (const String& mediaId, int height)
+{
+    const auto name = String::toHexString (mediaId.hashCode64()) + "_" + String (height) + ".tiles";
+
+    auto& tiles = tileFiles [name];
+    if (tiles == nullptr)
+        tiles = std::make_unique<TileFile>(folder.getChildFile (name));
+
+    return tiles.get();
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    Copyright (c) 2019, Foleys Finest Audio - Daniel Walz
+    All rights reserved.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+    ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+    OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+    OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ThumbnailCache.h
+    Created: 17 Oct 2026 8:43:53pm
+    Author:  Daniel Walz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*
+    Thumbnails of video clips, shared by all FilmStrips of the TimeLine.
+
+    The thumbnails are identified by the media file, the time in milliseconds
+    and the height. Recently used ones are kept in memory within a budget, all
+    of them are stored on disk in the settings folder as JPEG tiles, one
+    memory mapped file per media file and height. That way reopening a project
+    or zooming shows the thumbnails without decoding the video again.
+*/
+class ThumbnailCache
+{
+public:
+    ThumbnailCache();
+    ~ThumbnailCache();
+
+    /** Returns the thumbnail if it is in memory, otherwise an invalid Image. This is cheap enough for paint(). */
+    Image getMemoryThumbnail (const String& mediaId, int64 millis, int height);
+
+    /** Returns the thumbnail from memory or disk, or an invalid Image if it wasn't decoded yet.
+        Reading from disk maps the tile file and decodes the JPEG, so call this from the thread pool only. */
+    Image getCachedThumbnail (const String& mediaId, int64 millis, int height);
+
+    /** Returns the thumbnail, decoding it from the clip if necessary. Call this from the thread pool only. */
+    Image getThumbnail (foleys::AVClip& clip, const String& mediaId, int64 millis, int height);
+
+    void setMemoryBudget (size_t bytes);
+
+    /** Returns the pool to run the decoding jobs */
+    ThreadPool& getThreadPool();
+
+    /** Returns a string identifying the media of the clip. Clips without a file are only cached in memory. */
+    static String getMediaId (const foleys::AVClip& clip);
+
+    static bool isPersistent (const String& mediaId);
+
+private:
+
+    class TileFile;
+
+    static String getKey (const String& mediaId, int64 millis, int height);
+
+    /** Both are called with the lock held. The TileFiles are never deleted before the cache. */
+    void addToMemory (const String& key, const Image& image);
+    TileFile* getTileFile (const String& mediaId, int height);
+
+    struct MemoryEntry
+    {
+        String key;
+        Image  image;
+        size_t bytes = 0;
+    };
+
+    CriticalSection lock;
+
+    std::list<MemoryEntry> memory;
+    std::map<String, std::list<MemoryEntry>::iterator> memoryLookup;
+    size_t memoryUsed   = 0;
+    size_t memoryBudget = 128 * 1024 * 1024;
+
+    File folder;
+    std::map<String, std::unique_ptr<TileFile>> tileFiles;
+
+    ThreadPool threadPool { 2 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThumbnailCache)
+};
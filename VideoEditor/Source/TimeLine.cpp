@@ -37,10 +37,14 @@ namespace IDs
 }
 
 //==============================================================================
-TimeLine::TimeLine (foleys::VideoEngine& theVideoEngine, Player& playerToUse, Properties& properiesToUse)
+TimeLine::TimeLine (foleys::VideoEngine& theVideoEngine, Player& playerToUse, Properties& properiesToUse,
+                    ThumbnailCache& thumbnailCacheToUse, PeakCache& peakCacheToUse, ProxyManager& proxyManagerToUse)
   : videoEngine (theVideoEngine),
     player (playerToUse),
-    properties (properiesToUse)
+    properties (properiesToUse),
+    thumbnailCache (thumbnailCacheToUse),
+    peakCache (peakCacheToUse),
+    proxyManager (proxyManagerToUse)
 {
     addAndMakeVisible (timemarker);
     timemarker.setAlwaysOnTop (true);
@@ -48,6 +52,9 @@ TimeLine::TimeLine (foleys::VideoEngine& theVideoEngine, Player& playerToUse, Pr
 
 TimeLine::~TimeLine()
 {
+    importPool.removeAllJobs (true, 5000);
+    cancelPendingUpdate();
+
     if (edit)
     {
         edit->removeTimecodeListener (this);
@@ -68,6 +75,59 @@ void TimeLine::paint (Graphics& g)
     g.setColour (Colours::darkgrey.darker());
     for (int i=0; i < numAudioLines; ++i)
         g.fillRect (0, numVideoLines * (videoHeight + margin) + margin + i * (audioHeight + margin), getWidth(), audioHeight);
+
+    if (edit == nullptr)
+        return;
+
+    if (! laneIndexValid)
+        rebuildLaneIndex();
+
+    if (spansPixelsPerSecond != pixelsPerSecond)
+        rebuildSpans();
+
+    // only the spans in the area to repaint are visited, so the cost doesn't grow with the edit
+    const auto area  = g.getClipBounds();
+    const auto left  = getTimeFromX (area.getX());
+    const auto right = getTimeFromX (area.getRight() + 1);
+
+    auto paintSpans = [&](const std::vector<Range<double>>& spans, int y, int height)
+    {
+        auto it = std::upper_bound (spans.begin(), spans.end(), left,
+                                    [](double time, const Range<double>& span) { return time < span.getEnd(); });
+
+        for (; it != spans.end() && it->getStart() < right; ++it)
+        {
+            const auto x = getXFromTime (it->getStart());
+            g.fillRoundedRectangle (Rectangle<int> (x, y, jmax (2, getXFromTime (it->getEnd()) - x), height).reduced (0, 1).toFloat(), 2.0f);
+        }
+    };
+
+    g.setColour (Colours::orange.darker());
+    for (int i=0; i < numVideoLines; ++i)
+        paintSpans (videoSpans [size_t (i)], margin + i * (videoHeight + margin), videoHeight);
+
+    g.setColour (Colours::darkgreen);
+    for (int i=0; i < numAudioLines; ++i)
+        paintSpans (audioSpans [size_t (i)], numVideoLines * (videoHeight + margin) + margin + i * (audioHeight + margin), audioHeight);
+}
+
+void TimeLine::paintOverChildren (Graphics& g)
+{
+    const auto loop = player.getLoopRange();
+    if (loop.isEmpty())
+        return;
+
+    const auto left   = getXFromTime (loop.getStart());
+    const auto right  = getXFromTime (loop.getEnd());
+    const auto colour = player.isLooping() ? Colours::yellow : Colours::grey;
+
+    g.setColour (colour.withAlpha (0.1f));
+    g.fillRect (left, 0, right - left, getHeight());
+
+    g.setColour (colour);
+    g.fillRect (left, 0, right - left, 3);
+    g.fillRect (left, 0, 1, getHeight());
+    g.fillRect (right - 1, 0, 1, getHeight());
 }
 
 void TimeLine::resized()
@@ -75,37 +135,445 @@ void TimeLine::resized()
     if (edit == nullptr)
         return;
 
-    auto sampleRate = getSampleRate();
-    if (sampleRate == 0)
-        sampleRate = 48000.0;
+    const auto newPixelsPerSecond = getWidth() / timelineLength;
+    if (newPixelsPerSecond != pixelsPerSecond)
+    {
+        pixelsPerSecond = newPixelsPerSecond;
+
+        for (auto* entry : visibleEntries)
+            layoutClip (*entry->component);
+
+        updateVisibleComponents();
+        repaint();
+    }
 
-    timelineLength = std::max (60.0, edit->getLengthInSeconds() * 1.1);
+    for (auto& import : imports)
+        if (import->placeholder)
+            import->placeholder->setBounds (getPlaceholderBounds (*import));
 
-    for (auto& component : clipComponents)
+    timemarker.setTime (player.getCurrentTimeInSeconds());
+    timemarker.update();
+}
+
+void TimeLine::setZoom (double pixelsPerSecondToUse, double anchorTime)
+{
+    auto* viewport = findParentComponentOfClass<Viewport>();
+    const auto anchorX = getXFromTime (anchorTime) - (viewport != nullptr ? viewport->getViewPositionX() : 0);
+
+    zoom = pixelsPerSecondToUse;
+    updateSize();
+
+    if (viewport != nullptr)
+        viewport->setViewPosition (getXFromTime (anchorTime) - anchorX, viewport->getViewPositionY());
+}
+
+double TimeLine::getPixelsPerSecond() const
+{
+    return pixelsPerSecond;
+}
+
+void TimeLine::zoomToFit()
+{
+    zoom = 0.0;
+    updateSize();
+}
+
+void TimeLine::updateSize()
+{
+    timelineLength = edit != nullptr ? std::max (60.0, edit->getLengthInSeconds() * 1.1) : 60.0;
+
+    auto visibleWidth = getWidth();
+    if (auto* viewport = findParentComponentOfClass<Viewport>())
+        visibleWidth = viewport->getMaximumVisibleWidth();
+
+    const auto fit = visibleWidth / timelineLength;
+    if (zoom > 0.0)
+        zoom = jlimit (fit, std::max (fit, maxPixelsPerSecond), zoom);
+
+    const auto width = jmax (visibleWidth, roundToInt (timelineLength * (zoom > 0.0 ? zoom : fit)));
+
+    if (width != getWidth())
+        setSize (width, getHeight());
+    else
+        resized();
+}
+
+void TimeLine::moved()
+{
+    // scrolled by the viewport
+    updateVisibleComponents();
+}
+
+Rectangle<int> TimeLine::getClipBounds (const ClipComponent& component) const
+{
+    const auto x = getXFromTime (component.clip->getStart());
+    const auto w = getXFromTime (component.clip->getLength());
+
+    if (component.isVideoClip())
+        return { x, margin + getVideoLine (component.clip) * (videoHeight + margin), w, videoHeight };
+
+    return { x, numVideoLines * (videoHeight + margin) + margin + getAudioLine (component.clip) * (audioHeight + margin), w, audioHeight };
+}
+
+void TimeLine::layoutClip (ClipComponent& component)
+{
+    const auto bounds = getClipBounds (component);
+    component.setBounds (bounds);
+
+    // the playhead passing over a clip draws the cached image instead of the strips and graphs
+    component.setBufferedToImage (bounds.getWidth() <= maxBufferedWidth);
+}
+
+Range<double> TimeLine::getVisibleTimeRange() const
+{
+    auto area = getLocalBounds();
+    if (auto* viewport = findParentComponentOfClass<Viewport>())
+        area = viewport->getViewArea();
+
+    return { getTimeFromX (area.getX()), getTimeFromX (area.getRight()) };
+}
+
+void TimeLine::rebuildLaneIndex()
+{
+    for (auto& lane : videoLanes)
+        lane.clear();
+
+    for (auto& lane : audioLanes)
+        lane.clear();
+
+    for (auto& item : clipEntries)
     {
-        if (component->isVideoClip())
+        auto& entry = *item.second;
+        entry.lane  = entry.video ? jlimit (0, numVideoLines - 1, getVideoLine (entry.clip))
+                                  : jlimit (0, numAudioLines - 1, getAudioLine (entry.clip));
+        entry.indexedStart = entry.clip->getStart();
+
+        getLane (entry).add (&entry, entry.indexedStart, entry.indexedStart + entry.clip->getLength());
+    }
+
+    for (auto& lane : videoLanes)
+        lane.build();
+
+    for (auto& lane : audioLanes)
+        lane.build();
+
+    laneIndexValid = true;
+    spansPixelsPerSecond = 0.0;
+    repaint();
+}
+
+void TimeLine::indexClip (ClipEntry& entry)
+{
+    if (! laneIndexValid)
+        return;
+
+    unindexClip (entry);
+
+    entry.lane = entry.video ? jlimit (0, numVideoLines - 1, getVideoLine (entry.clip))
+                             : jlimit (0, numAudioLines - 1, getAudioLine (entry.clip));
+    entry.indexedStart = entry.clip->getStart();
+
+    getLane (entry).insert (&entry, entry.indexedStart, entry.indexedStart + entry.clip->getLength());
+    spansPixelsPerSecond = 0.0;
+}
+
+void TimeLine::unindexClip (ClipEntry& entry)
+{
+    if (! laneIndexValid || entry.lane < 0)
+        return;
+
+    getLane (entry).remove (&entry, entry.indexedStart);
+    entry.lane = -1;
+    spansPixelsPerSecond = 0.0;
+}
+
+TimeLine::LaneIndex& TimeLine::getLane (const ClipEntry& entry)
+{
+    return entry.video ? videoLanes [size_t (entry.lane)] : audioLanes [size_t (entry.lane)];
+}
+
+const void* TimeLine::getStateKey (const ValueTree& state)
+{
+    return &state.getProperties();
+}
+
+void TimeLine::rebuildSpans()
+{
+    // gaps smaller than two pixels are not visible anyway
+    const auto minGap = 2.0 / jmax (pixelsPerSecond, 0.001);
+
+    videoSpans.resize (videoLanes.size());
+    for (size_t i = 0; i < videoLanes.size(); ++i)
+        videoSpans [i] = videoLanes [i].getSpans (minGap);
+
+    audioSpans.resize (audioLanes.size());
+    for (size_t i = 0; i < audioLanes.size(); ++i)
+        audioSpans [i] = audioLanes [i].getSpans (minGap);
+
+    spansPixelsPerSecond = pixelsPerSecond;
+}
+
+bool TimeLine::isOverview() const
+{
+    return pixelsPerSecond < overviewPixelsPerSecond;
+}
+
+void TimeLine::updateVisibleComponents()
+{
+    if (edit == nullptr)
+        return;
+
+    if (! laneIndexValid)
+        rebuildLaneIndex();
+
+    // keep the neighbours alive, so scrolling doesn't create components all the time
+    const auto visible = getVisibleTimeRange();
+    const auto range   = visible.expanded (visible.getLength() * 0.5);
+
+    ++visibleGeneration;
+
+    // clips too narrow for their strips are only painted as spans
+    const auto minLength = minClipWidth / jmax (pixelsPerSecond, 0.001);
+
+    auto markVisible = [this, minLength](ClipEntry& entry)
+    {
+        if (entry.clip->getLength() < minLength)
+            return;
+
+        entry.visibleGeneration = visibleGeneration;
+        if (entry.component == nullptr)
+            acquireComponent (entry);
+    };
+
+    if (! isOverview())
+    {
+        for (const auto& lane : videoLanes)
+            lane.forEachInRange (range, markVisible);
+
+        for (const auto& lane : audioLanes)
+            lane.forEachInRange (range, markVisible);
+    }
+
+    visibleEntries.erase (std::remove_if (visibleEntries.begin(), visibleEntries.end(), [this](ClipEntry* entry)
+    {
+        // a clip is never taken away while it is dragged
+        if (entry->visibleGeneration == visibleGeneration || entry->component->isMouseButtonDown())
+            return false;
+
+        releaseComponent (*entry);
+        return true;
+    }), visibleEntries.end());
+}
+
+TimeLine::ClipComponent* TimeLine::acquireComponent (ClipEntry& entry)
+{
+    auto& pool = entry.video ? videoPool : audioPool;
+    ClipComponent* component = nullptr;
+
+    if (pool.empty())
+    {
+        clipComponents.push_back (std::make_unique<ClipComponent> (*this, entry.clip, videoEngine.getThreadPool(), entry.video));
+        component = clipComponents.back().get();
+        addChildComponent (component);
+    }
+    else
+    {
+        component = pool.back();
+        pool.pop_back();
+        component->setClip (entry.clip);
+    }
+
+    entry.component = component;
+    visibleEntries.push_back (&entry);
+
+    layoutClip (*component);
+    component->setVisible (true);
+    return component;
+}
+
+void TimeLine::releaseComponent (ClipEntry& entry)
+{
+    auto* component = entry.component;
+    if (component == nullptr)
+        return;
+
+    // releasing the clip cancels the thumbnail and waveform jobs of the strips
+    component->setVisible (false);
+    component->setClip (nullptr);
+    (entry.video ? videoPool : audioPool).push_back (component);
+    entry.component = nullptr;
+}
+
+void TimeLine::handleAsyncUpdate()
+{
+    if (clipsAddedOrRemoved)
+    {
+        clipsAddedOrRemoved = false;
+
+        // the removed clips are gone already, the added ones only have their descriptors now
+        auto needsRestore = false;
+        for (const auto& added : addedClips)
         {
-            int videoline = component->clip->getStatusTree().getProperty (IDs::videoLine, 0);
-            component->setBounds (getXFromTime (component->clip->getStart()), margin + videoline * (videoHeight + margin),
-                                  getXFromTime (component->clip->getLength()), videoHeight);
+            auto descriptor = findClip (added.second);
+            if (descriptor == nullptr)
+            {
+                needsRestore = true;
+                break;
+            }
+
+            addClipEntries (descriptor);
         }
-        else
+
+        addedClips.clear();
+
+        if (needsRestore)
+            restoreClipComponents();
+
+        repaint();
+        updateSize();
+    }
+
+    if (! changedClips.empty())
+    {
+        if (changedClips.size() > maxIncrementalChanges)
+            laneIndexValid = false;
+
+        // only the clips that were changed move, in the lane index and on screen
+        for (const auto& changed : changedClips)
         {
-            int audioline = component->clip->getStatusTree().getProperty (IDs::audioLine, 0);
-            component->setBounds (getXFromTime (component->clip->getStart()), numVideoLines * (videoHeight + margin) + margin + audioline * (audioHeight + margin),
-                                  getXFromTime (component->clip->getLength()), audioHeight);
+            auto descriptor = clipsByState.find (changed.first);
+            if (descriptor == clipsByState.end())
+                continue;
+
+            for (auto video : { true, false })
+            {
+                auto item = clipEntries.find ({ descriptor->second, video });
+                if (item == clipEntries.end())
+                    continue;
+
+                auto& entry = *item->second;
+                indexClip (entry);
+
+                if (entry.component != nullptr)
+                    layoutClip (*entry.component);
+            }
         }
+
+        changedClips.clear();
+        repaint();
+
+        // the edit might have become longer, which changes the scale
+        updateSize();
+    }
+
+    updateVisibleComponents();
+}
+
+//==============================================================================
+
+void TimeLine::LaneIndex::clear()
+{
+    entries.clear();
+    maxEnd.clear();
+}
+
+void TimeLine::LaneIndex::add (ClipEntry* entry, double start, double end)
+{
+    entries.push_back ({ start, end, entry });
+}
+
+void TimeLine::LaneIndex::build()
+{
+    std::sort (entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.start < b.start; });
+
+    maxEnd.resize (entries.size());
+    auto runningMax = std::numeric_limits<double>::lowest();
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        runningMax = std::max (runningMax, entries [i].end);
+        maxEnd [i] = runningMax;
+    }
+}
+
+void TimeLine::LaneIndex::insert (ClipEntry* entry, double start, double end)
+{
+    auto it = std::upper_bound (entries.begin(), entries.end(), start,
+                                [](double time, const Entry& other) { return time < other.start; });
+    const auto index = size_t (std::distance (entries.begin(), it));
+
+    entries.insert (it, { start, end, entry });
+    maxEnd.insert (maxEnd.begin() + long (index), end);
+    updateMaxEnd (index);
+}
+
+void TimeLine::LaneIndex::remove (ClipEntry* entry, double start)
+{
+    auto it = std::lower_bound (entries.begin(), entries.end(), start,
+                                [](const Entry& other, double time) { return other.start < time; });
+
+    while (it != entries.end() && it->start == start && it->clip != entry)
+        ++it;
+
+    if (it == entries.end() || it->clip != entry)
+    {
+        jassertfalse;
+        return;
+    }
+
+    const auto index = size_t (std::distance (entries.begin(), it));
+    entries.erase (it);
+    maxEnd.erase (maxEnd.begin() + long (index));
+    updateMaxEnd (index);
+}
+
+void TimeLine::LaneIndex::updateMaxEnd (size_t from)
+{
+    auto runningMax = from > 0 ? maxEnd [from - 1] : std::numeric_limits<double>::lowest();
+
+    for (auto i = from; i < entries.size(); ++i)
+    {
+        runningMax = std::max (runningMax, entries [i].end);
+
+        // once it is the same as before, the rest is too
+        if (i > from && maxEnd [i] == runningMax)
+            return;
+
+        maxEnd [i] = runningMax;
+    }
+}
+
+std::vector<Range<double>> TimeLine::LaneIndex::getSpans (double minGap) const
+{
+    std::vector<Range<double>> spans;
+
+    for (const auto& entry : entries)
+    {
+        if (! spans.empty() && entry.start <= spans.back().getEnd() + minGap)
+            spans.back() = spans.back().withEnd (std::max (spans.back().getEnd(), entry.end));
+        else
+            spans.push_back ({ entry.start, entry.end });
     }
 
-    auto tx = getXFromTime (player.getCurrentTimeInSeconds());
-    timemarker.setBounds (tx, 0, 3, getHeight());
+    return spans;
 }
 
+//==============================================================================
+
 void TimeLine::timecodeChanged (int64_t count, double seconds)
 {
-    ignoreUnused (time);
-    auto tx = getXFromTime (seconds);
-    timemarker.setBounds (tx, 0, 3, getHeight());
+    ignoreUnused (count);
+    timemarker.setTime (seconds);
+}
+
+void TimeLine::mouseWheelMove (const MouseEvent& event, const MouseWheelDetails& wheel)
+{
+    if (! event.mods.isCommandDown())
+    {
+        Component::mouseWheelMove (event, wheel);
+        return;
+    }
+
+    setZoom (pixelsPerSecond * std::pow (2.0, wheel.deltaY * 2.0), getTimeFromX (event.x));
 }
 
 void TimeLine::mouseDown (const MouseEvent& event)
@@ -123,9 +591,11 @@ void TimeLine::filesDropped (const StringArray& files, int x, int y)
     if (files.isEmpty() || edit == nullptr)
         return;
 
-    auto clip = videoEngine.createClipFromFile (files [0]);
-    if (clip.get() != nullptr)
-        addClipToEdit (clip, getTimeFromX (x), y);
+    Array<URL> urls;
+    for (const auto& file : files)
+        urls.add (URL (File (file)));
+
+    importMedia (urls, getTimeFromX (x), y);
 }
 
 bool TimeLine::isInterestedInDragSource (const SourceDetails &dragSourceDetails)
@@ -141,25 +611,19 @@ void TimeLine::itemDropped (const SourceDetails &dragSourceDetails)
     if (edit == nullptr)
         return;
 
+    const auto start = getTimeFromX (dragSourceDetails.localPosition.x);
+
     if (auto* source = dynamic_cast<FileTreeComponent*> (dragSourceDetails.sourceComponent.get()))
     {
-        auto clip = videoEngine.createClipFromFile (URL (source->getSelectedFile()));
+        Array<URL> urls;
+        for (int i = 0; i < source->getNumSelectedFiles(); ++i)
+            urls.add (URL (source->getSelectedFile (i)));
 
-        if (clip.get() == nullptr)
-        {
-            AlertWindow::showNativeDialogBox (NEEDS_TRANS ("Loading failed"), NEEDS_TRANS (""), true);
-            return;
-        }
-
-        addClipToEdit (clip, getTimeFromX (dragSourceDetails.localPosition.x), dragSourceDetails.localPosition.y);
+        importMedia (urls, start, dragSourceDetails.localPosition.y);
         return;
     }
 
-    auto url = dragSourceDetails.description.toString();
-
-    auto clip = videoEngine.createClipFromFile (juce::URL (url));
-    if (clip.get() != nullptr)
-        addClipToEdit (clip, getTimeFromX (dragSourceDetails.localPosition.x), dragSourceDetails.localPosition.y);
+    importMedia ({ juce::URL (dragSourceDetails.description.toString()) }, start, dragSourceDetails.localPosition.y);
 }
 
 bool TimeLine::isInterestedInTextDrag (const String& text)
@@ -173,12 +637,128 @@ void TimeLine::textDropped (const String& text, int x, int y)
     if (edit.get() == nullptr)
         return;
 
-    auto clip = videoEngine.createClipFromFile (juce::URL (text));
-    if (clip.get() != nullptr)
-        addClipToEdit (clip, getTimeFromX (x), y);
+    importMedia ({ juce::URL (text) }, getTimeFromX (x), y);
+}
+
+void TimeLine::importMedia (const Array<URL>& urls, double start, int y)
+{
+    const auto group = nextImportGroup++;
+    importGroupEnds [group] = start;
+
+    for (const auto& url : urls)
+    {
+        auto import = std::make_unique<PendingImport>();
+        import->url   = url;
+        import->id    = nextImportId++;
+        import->group = group;
+        import->start = start;
+        import->y     = y;
+        import->placeholder = std::make_unique<ImportPlaceholder> (url.getFileName());
+        addAndMakeVisible (*import->placeholder);
+        import->placeholder->setBounds (getPlaceholderBounds (*import));
+
+        start += placeholderLength;
+
+        // ProxyManager is not thread safe, the proxy is looked up here. The job
+        // doesn't use this, so it can't outlive the TimeLine.
+        importPool.addJob ([&engine = videoEngine, &cache = thumbnailCache, self = SafePointer<TimeLine> (this),
+                            url, proxy = proxyManager.getProxyFor (url), id = import->id, height = videoHeight - 25]
+        {
+            auto clip = createClip (engine, cache, url, proxy, height);
+
+            MessageManager::callAsync ([self, id, clip]
+            {
+                if (self != nullptr)
+                    self->importFinished (id, clip);
+            });
+
+            return ThreadPoolJob::jobHasFinished;
+        });
+
+        imports.push_back (std::move (import));
+    }
+}
+
+void TimeLine::importFinished (int importId, std::shared_ptr<foleys::AVClip> clip)
+{
+    // the edit was replaced in the meantime
+    auto it = std::find_if (imports.begin(), imports.end(), [importId](const auto& pending) { return pending->id == importId; });
+    if (it == imports.end())
+        return;
+
+    auto* import = it->get();
+
+    import->finished = true;
+    import->clip = clip;
+    import->placeholder.reset();
+
+    if (clip == nullptr)
+        AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, NEEDS_TRANS ("Loading failed"),
+                                          "Loading of \"" + import->url.toString (false) + "\" failed.");
+    else if (clip->hasVideo() && std::dynamic_pointer_cast<foleys::ImageClip>(clip) == nullptr)
+        proxyManager.requestProxy (import->url);
+
+    // the clips of one drop are added in order, each one after the previous
+    std::set<int> waiting;
+    for (auto pending = imports.begin(); pending != imports.end();)
+    {
+        auto& entry = **pending;
+
+        if (waiting.count (entry.group) > 0 || ! entry.finished)
+        {
+            waiting.insert (entry.group);
+            ++pending;
+            continue;
+        }
+
+        if (entry.clip != nullptr)
+        {
+            auto& end = importGroupEnds [entry.group];
+            if (auto descriptor = addClipToEdit (entry.clip, end, entry.y))
+                end = descriptor->getStart() + descriptor->getLength();
+        }
+
+        pending = imports.erase (pending);
+    }
+
+    for (auto group = importGroupEnds.begin(); group != importGroupEnds.end();)
+        group = waiting.count (group->first) > 0 ? std::next (group) : importGroupEnds.erase (group);
+}
+
+Rectangle<int> TimeLine::getPlaceholderBounds (const PendingImport& import) const
+{
+    const auto x = getXFromTime (import.start);
+    const auto w = jmax (40, getXFromTime (placeholderLength));
+
+    if (import.y < 190)
+    {
+        const auto line = jlimit (0, numVideoLines - 1, (import.y - margin) / (videoHeight + margin));
+        return { x, margin + line * (videoHeight + margin), w, videoHeight };
+    }
+
+    const auto line = jlimit (0, numAudioLines - 1, (import.y - numVideoLines * (videoHeight + margin) + margin) / (audioHeight + margin));
+    return { x, numVideoLines * (videoHeight + margin) + margin + line * (audioHeight + margin), w, audioHeight };
+}
+
+std::shared_ptr<foleys::AVClip> TimeLine::createClip (foleys::VideoEngine& engine, ThumbnailCache& cache,
+                                                      const URL& url, const URL& proxy, int thumbnailHeight)
+{
+    std::shared_ptr<foleys::AVClip> clip;
+
+    if (! proxy.isEmpty())
+        clip = engine.createClipFromFile (proxy);
+
+    if (clip == nullptr)
+        clip = engine.createClipFromFile (url);
+
+    // the first thumbnail is ready when the FilmStrip shows up
+    if (clip != nullptr && clip->hasVideo())
+        cache.getThumbnail (*clip, ThumbnailCache::getMediaId (*clip), 0, thumbnailHeight);
+
+    return clip;
 }
 
-void TimeLine::addClipToEdit (std::shared_ptr<foleys::AVClip> clip, double start, int y)
+std::shared_ptr<foleys::ClipDescriptor> TimeLine::addClipToEdit (std::shared_ptr<foleys::AVClip> clip, double start, int y)
 {
     auto length = -1.0;
 
@@ -192,29 +772,84 @@ void TimeLine::addClipToEdit (std::shared_ptr<foleys::AVClip> clip, double start
         length = editLength > start ? std::min (editLength - start, 60.0) : 60.0;
     }
 
-    auto descriptor = edit->addClip (clip, start, length);
-    if (y < 190)
+    auto descriptor = edit->addClip (clip, start, length);
+    if (y < 190)
+    {
+        int line = (y - margin) / double (videoHeight + margin);
+        setVideoLine (descriptor, line);
+    }
+    else
+    {
+        int line = (y - numVideoLines * (videoHeight + margin) + margin) / (audioHeight + margin);
+        setAudioLine (descriptor, line);
+    }
+
+    addClipEntries (descriptor);
+    updateVisibleComponents();
+
+    setSelectedClip (descriptor, descriptor->clip->hasVideo());
+    updateSize();
+
+    return descriptor;
+}
+
+void TimeLine::setSelectedClip (std::shared_ptr<foleys::ClipDescriptor> clip, bool video)
+{
+    selectedClip = clip;
+    selectedIsVideo = video;
+    selection.clear();
+
+    if (clip != nullptr)
+        selection.push_back (clip);
+
+    properties.showClipProperties (videoEngine, clip, player, video);
+    repaintClips();
+}
+
+void TimeLine::toggleSelectedClip (std::shared_ptr<foleys::ClipDescriptor> clip, bool video)
+{
+    if (clip == nullptr)
+        return;
+
+    auto it = std::find_if (selection.begin(), selection.end(), [&clip](const auto& selected) { return selected.lock() == clip; });
+    if (it == selection.end())
     {
-        int line = (y - margin) / double (videoHeight + margin);
-        setVideoLine (descriptor, line);
+        selection.push_back (clip);
+        selectedClip = clip;
+        selectedIsVideo = video;
+        properties.showClipProperties (videoEngine, clip, player, video);
     }
     else
     {
-        int line = (y - numVideoLines * (videoHeight + margin) + margin) / (audioHeight + margin);
-        setAudioLine (descriptor, line);
+        selection.erase (it);
+        if (selectedClip.lock() == clip)
+        {
+            selectedClip.reset();
+            properties.closeProperties();
+        }
     }
 
-    restoreClipComponents();
+    repaintClips();
+}
 
-    setSelectedClip (descriptor, descriptor->clip->hasVideo());
-    resized();
+void TimeLine::selectAllClips()
+{
+    if (edit == nullptr)
+        return;
+
+    selection.clear();
+    for (const auto& descriptor : edit->getClips())
+        selection.push_back (descriptor);
+
+    repaintClips();
 }
 
-void TimeLine::setSelectedClip (std::shared_ptr<foleys::ClipDescriptor> clip, bool video)
+void TimeLine::repaintClips()
 {
-    selectedClip = clip;
-    selectedIsVideo = video;
-    properties.showClipProperties (videoEngine, clip, player, video);
+    // the ClipComponents are buffered, repainting the timeline doesn't reach them
+    for (auto* entry : visibleEntries)
+        entry->component->repaint();
+
     repaint();
 }
 
@@ -223,6 +858,21 @@ std::shared_ptr<foleys::ClipDescriptor> TimeLine::getSelectedClip() const
     return selectedClip.lock();
 }
 
+std::vector<std::shared_ptr<foleys::ClipDescriptor>> TimeLine::getSelectedClips() const
+{
+    std::vector<std::shared_ptr<foleys::ClipDescriptor>> clips;
+    for (const auto& selected : selection)
+        if (auto clip = selected.lock())
+            clips.push_back (clip);
+
+    return clips;
+}
+
+bool TimeLine::isSelected (const foleys::ClipDescriptor* clip) const
+{
+    return std::any_of (selection.begin(), selection.end(), [clip](const auto& selected) { return selected.lock().get() == clip; });
+}
+
 bool TimeLine::selectedClipIsVideo() const
 {
     return selectedIsVideo;
@@ -234,12 +884,23 @@ void TimeLine::toggleVisibility()
     if (clip.get() == nullptr)
         return;
 
+    ScopedBatch batch (*this, NEEDS_TRANS ("Visibility"));
+
+    // all selected clips follow the clip with the properties
     if (selectedIsVideo)
-        clip->setVideoVisible (! clip->getVideoVisible());
+    {
+        const auto visible = ! clip->getVideoVisible();
+        for (auto& selected : getSelectedClips())
+            selected->setVideoVisible (visible);
+    }
     else
-        clip->setAudioPlaying (! clip->getAudioPlaying());
+    {
+        const auto playing = ! clip->getAudioPlaying();
+        for (auto& selected : getSelectedClips())
+            selected->setAudioPlaying (playing);
+    }
 
-    repaint();
+    repaintClips();
 }
 
 void TimeLine::spliceSelectedClipAtPlayPosition()
@@ -249,16 +910,110 @@ void TimeLine::spliceSelectedClipAtPlayPosition()
 
 void TimeLine::spliceSelectedClipAtPosition (double pts)
 {
-    auto clip = selectedClip.lock();
-    if (clip.get() == nullptr)
+    auto clips = getSelectedClips();
+    if (clips.empty())
+        return;
+
+    ScopedBatch batch (*this, NEEDS_TRANS ("Splice"));
+
+    for (auto& clip : clips)
+        spliceClipAtPosition (clip, pts);
+}
+
+void TimeLine::spliceAllClipsAtPlayPosition()
+{
+    if (edit == nullptr)
+        return;
+
+    const auto pts = player.getCurrentTimeInSeconds();
+
+    ScopedBatch batch (*this, NEEDS_TRANS ("Splice All"));
+
+    // the new clips are appended, they are not in this copy of the list
+    auto clips = edit->getClips();
+    for (auto& clip : clips)
+        spliceClipAtPosition (clip, pts);
+}
+
+void TimeLine::deleteSelectedClips()
+{
+    auto clips = getSelectedClips();
+    if (clips.empty() || edit == nullptr)
+        return;
+
+    ScopedBatch batch (*this, NEEDS_TRANS ("Delete"));
+
+    for (auto& clip : clips)
+        edit->removeClip (clip);
+
+    selection.clear();
+    selectedClip.reset();
+    properties.closeProperties();
+    repaintClips();
+}
+
+void TimeLine::rippleDeleteSelectedClips()
+{
+    auto clips = getSelectedClips();
+    if (clips.empty() || edit == nullptr)
         return;
 
+    // the gaps to close, merged and sorted
+    std::vector<Range<double>> gaps;
+    for (auto& clip : clips)
+        gaps.push_back ({ clip->getStart(), clip->getStart() + clip->getLength() });
+
+    std::sort (gaps.begin(), gaps.end(), [](const auto& a, const auto& b) { return a.getStart() < b.getStart(); });
+
+    std::vector<Range<double>> merged;
+    for (const auto& gap : gaps)
+    {
+        if (! merged.empty() && gap.getStart() <= merged.back().getEnd())
+            merged.back() = merged.back().getUnionWith (gap);
+        else
+            merged.push_back (gap);
+    }
+
+    // shifts [i] is the length of all gaps before gap i
+    std::vector<double> shifts (merged.size() + 1, 0.0);
+    for (size_t i = 0; i < merged.size(); ++i)
+        shifts [i + 1] = shifts [i] + merged [i].getLength();
+
+    ScopedBatch batch (*this, NEEDS_TRANS ("Ripple Delete"));
+
+    for (auto& clip : clips)
+        edit->removeClip (clip);
+
+    for (auto& descriptor : edit->getClips())
+    {
+        const auto start = descriptor->getStart();
+        auto next = std::upper_bound (merged.begin(), merged.end(), start,
+                                      [](double time, const Range<double>& gap) { return time < gap.getEnd(); });
+        const auto index = size_t (std::distance (merged.begin(), next));
+
+        // a clip starting inside a gap moves to its beginning
+        auto newStart = start - shifts [index];
+        if (next != merged.end() && next->getStart() < start)
+            newStart = next->getStart() - shifts [index];
+
+        if (newStart != start)
+            descriptor->setStart (newStart);
+    }
+
+    selection.clear();
+    selectedClip.reset();
+    properties.closeProperties();
+    repaintClips();
+}
+
+bool TimeLine::spliceClipAtPosition (std::shared_ptr<foleys::ClipDescriptor> clip, double pts)
+{
     auto start  = clip->getStart();
     auto length = clip->getLength();
     auto offset = clip->getOffset() + (pts - start);
 
-    if (pts < start || pts > start + length)
-        return;
+    if (pts <= start || pts >= start + length)
+        return false;
 
     edit->getStatusTree().addChild (clip->getStatusTree().createCopy(), -1, videoEngine.getUndoManager());
     clip->setLength (pts - clip->getStart());
@@ -266,7 +1021,7 @@ void TimeLine::spliceSelectedClipAtPosition (double pts)
 
     auto newClip = edit->getClip (int (edit->getClips().size()) - 1);
     if (newClip.get() == nullptr)
-        return;
+        return false;
 
     newClip->setStart (pts);
     newClip->setLength (length - (pts - start));
@@ -274,6 +1029,7 @@ void TimeLine::spliceSelectedClipAtPosition (double pts)
 
     newClip->setDescription (edit->makeUniqueDescription(clip->getDescription()));
     newClip->updateSampleCounts();
+    return true;
 }
 
 void TimeLine::restoreClipComponents()
@@ -281,40 +1037,121 @@ void TimeLine::restoreClipComponents()
     if (edit == nullptr)
         return;
 
-    auto clips = edit->getClips();
-    for (auto descriptor : clips)
+    ++restoreGeneration;
+
+    // all entries are sorted again at once
+    laneIndexValid = false;
+
+    for (auto descriptor : edit->getClips())
     {
         if (descriptor->clip->hasVideo())
+            addClipEntry (descriptor, true).restoreGeneration = restoreGeneration;
+
+        if (descriptor->clip->hasAudio())
+            addClipEntry (descriptor, false).restoreGeneration = restoreGeneration;
+    }
+
+    // everything not visited above was removed from the edit
+    for (auto it = clipEntries.begin(); it != clipEntries.end();)
+    {
+        auto& entry = *it->second;
+        if (entry.restoreGeneration == restoreGeneration)
         {
-            auto comp = std::find_if (clipComponents.begin(), clipComponents.end(), [descriptor](const auto& comp){ return comp->isVideoClip() && comp->clip == descriptor; });
-            if (comp == clipComponents.end())
-                addClipComponent (descriptor, true);
+            ++it;
+            continue;
         }
 
-        if (descriptor->clip->hasAudio())
+        if (entry.component != nullptr)
         {
-            auto comp = std::find_if (clipComponents.begin(), clipComponents.end(), [descriptor](const auto& comp){ return !comp->isVideoClip() && comp->clip == descriptor; });
-            if (comp == clipComponents.end())
-                addClipComponent (descriptor, false);
+            releaseComponent (entry);
+            visibleEntries.erase (std::remove (visibleEntries.begin(), visibleEntries.end(), &entry), visibleEntries.end());
         }
+
+        clipsByState.erase (getStateKey (entry.clip->getStatusTree()));
+        it = clipEntries.erase (it);
     }
 
-    clipComponents.erase (std::remove_if (clipComponents.begin(),
-                                          clipComponents.end(),
-                                          [&](auto& component)
-                                          {
-                                              auto findClipWithComponent = [&](const auto& clip){ return clip == component->clip; };
-                                              return std::find_if (clips.begin(), clips.end(), findClipWithComponent) == clips.end();
-                                          }), clipComponents.end());
+    addedClips.clear();
+    updateVisibleComponents();
+    updateSize();
+}
 
-    resized();
+void TimeLine::updateClipsNow()
+{
+    handleUpdateNowIfNeeded();
+}
+
+void TimeLine::addClipEntries (std::shared_ptr<foleys::ClipDescriptor> descriptor)
+{
+    if (descriptor->clip->hasVideo())
+        addClipEntry (descriptor, true);
+
+    if (descriptor->clip->hasAudio())
+        addClipEntry (descriptor, false);
+}
+
+TimeLine::ClipEntry& TimeLine::addClipEntry (std::shared_ptr<foleys::ClipDescriptor> descriptor, bool video)
+{
+    auto& entry = clipEntries [{ descriptor.get(), video }];
+    if (entry == nullptr)
+    {
+        entry = std::make_unique<ClipEntry> (ClipEntry { descriptor, video });
+        clipsByState [getStateKey (descriptor->getStatusTree())] = descriptor.get();
+        indexClip (*entry);
+
+        // start building the waveform overview right on import, not when it scrolls into view
+        if (! video)
+            peakCache.getPeakFile (descriptor->clip->getMediaFile());
+    }
+
+    return *entry;
+}
+
+void TimeLine::removeClipEntries (const ValueTree& state)
+{
+    const auto key = getStateKey (state);
+    addedClips.erase (key);
+    changedClips.erase (key);
+
+    auto descriptor = clipsByState.find (key);
+    if (descriptor == clipsByState.end())
+        return;
+
+    for (auto video : { true, false })
+    {
+        auto item = clipEntries.find ({ descriptor->second, video });
+        if (item == clipEntries.end())
+            continue;
+
+        auto& entry = *item->second;
+        unindexClip (entry);
+
+        if (entry.component != nullptr)
+        {
+            releaseComponent (entry);
+            visibleEntries.erase (std::remove (visibleEntries.begin(), visibleEntries.end(), &entry), visibleEntries.end());
+        }
+
+        clipEntries.erase (item);
+    }
+
+    clipsByState.erase (descriptor);
 }
 
-void TimeLine::addClipComponent (std::shared_ptr<foleys::ClipDescriptor> clip, bool video)
+std::shared_ptr<foleys::ClipDescriptor> TimeLine::findClip (const ValueTree& state) const
 {
-    auto strip = std::make_unique<ClipComponent> (*this, clip, videoEngine.getThreadPool(), video);
-    addAndMakeVisible (strip.get());
-    clipComponents.emplace_back (std::move (strip));
+    // the clips are in the order of their states, and most are added at the end
+    auto tree  = edit->getStatusTree();
+    auto index = tree.getNumChildren() - 1;
+
+    if (tree.getChild (index) != state)
+        index = tree.indexOf (state);
+
+    if (index < 0)
+        return {};
+
+    auto descriptor = edit->getClip (index);
+    return descriptor != nullptr && descriptor->getStatusTree() == state ? descriptor : nullptr;
 }
 
 void TimeLine::setEditClip (std::shared_ptr<foleys::ComposedClip> clip)
@@ -325,7 +1162,37 @@ void TimeLine::setEditClip (std::shared_ptr<foleys::ComposedClip> clip)
         edit->getStatusTree().removeListener (this);
     }
 
+    for (auto& item : clipEntries)
+        releaseComponent (*item.second);
+
+    clipEntries.clear();
+    visibleEntries.clear();
+    laneIndexValid = false;
+
+    // running imports belong to the previous edit
+    imports.clear();
+    importGroupEnds.clear();
+
+    edit.reset();
+    pendingEdit = clip;
+    changedClips.clear();
+    addedClips.clear();
+    clipsByState.clear();
+    updateSize();
+
+    // the loop range belongs to the previous edit
+    player.setLoopRange ({});
+    player.setClip (clip, true, [self = SafePointer<TimeLine> (this), clip]
+    {
+        if (self != nullptr && self->pendingEdit == clip)
+            self->attachEdit (clip);
+    });
+}
+
+void TimeLine::attachEdit (std::shared_ptr<foleys::ComposedClip> clip)
+{
     edit = clip;
+    pendingEdit.reset();
 
     if (edit)
     {
@@ -334,13 +1201,36 @@ void TimeLine::setEditClip (std::shared_ptr<foleys::ComposedClip> clip)
     }
 
     restoreClipComponents();
+    updateSize();
+}
 
-    player.setClip (edit, true);
+void TimeLine::setLoopIn (double seconds)
+{
+    const auto loop = player.getLoopRange();
+    const auto end  = loop.getEnd() > seconds ? loop.getEnd() : (edit != nullptr ? edit->getLengthInSeconds() : 0.0);
+
+    player.setLoopRange ({ seconds, end });
+    repaint();
+}
+
+void TimeLine::setLoopOut (double seconds)
+{
+    const auto loop  = player.getLoopRange();
+    const auto start = loop.getStart() < seconds ? loop.getStart() : 0.0;
+
+    player.setLoopRange ({ start, seconds });
+    repaint();
+}
+
+void TimeLine::toggleLooping()
+{
+    player.setLooping (! player.isLooping());
+    repaint();
 }
 
 std::shared_ptr<foleys::ComposedClip> TimeLine::getEditClip() const
 {
-    return edit;
+    return edit != nullptr ? edit : pendingEdit;
 }
 
 int TimeLine::getXFromTime (double seconds) const
@@ -386,44 +1276,138 @@ double TimeLine::getSampleRate() const
 void TimeLine::valueTreePropertyChanged (juce::ValueTree& treeWhosePropertyHasChanged,
                                          const juce::Identifier& property)
 {
-    MessageManager::callAsync ([safeComponent = SafePointer<TimeLine> (this)] () mutable { if (safeComponent) safeComponent->resized(); });
+    if (edit == nullptr)
+        return;
+
+    // changes further down, e.g. automation keyframes, don't move the clip
+    if (treeWhosePropertyHasChanged.getParent() != edit->getStatusTree())
+        return;
+
+    changedClips [getStateKey (treeWhosePropertyHasChanged)] = treeWhosePropertyHasChanged;
+
+    if (batchDepth == 0)
+        triggerAsyncUpdate();
 }
 
 void TimeLine::valueTreeChildAdded (juce::ValueTree& parentTree,
                                     juce::ValueTree& childWhichHasBeenAdded)
 {
-    MessageManager::callAsync ([safeComponent = SafePointer<TimeLine> (this)] () mutable { if (safeComponent) safeComponent->restoreClipComponents(); });
+    if (edit != nullptr && parentTree == edit->getStatusTree())
+    {
+        // the edit might create the descriptor after this call
+        addedClips [getStateKey (childWhichHasBeenAdded)] = childWhichHasBeenAdded;
+        clipsAddedOrRemoved = true;
+
+        if (batchDepth == 0)
+            triggerAsyncUpdate();
+    }
 }
 
 void TimeLine::valueTreeChildRemoved (juce::ValueTree& parentTree,
                                       juce::ValueTree& childWhichHasBeenRemoved,
                                       int indexFromWhichChildWasRemoved)
 {
-    MessageManager::callAsync ([safeComponent = SafePointer<TimeLine> (this)] () mutable { if (safeComponent) safeComponent->restoreClipComponents(); });
+    if (edit != nullptr && parentTree == edit->getStatusTree())
+    {
+        // the entries keep their descriptors alive, so they can go right away
+        removeClipEntries (childWhichHasBeenRemoved);
+        clipsAddedOrRemoved = true;
+
+        if (batchDepth == 0)
+            triggerAsyncUpdate();
+    }
 }
 
 //==============================================================================
 
-TimeLine::ClipComponent::ClipComponent (TimeLine& tl,
-                                        std::shared_ptr<foleys::ClipDescriptor> clipToUse,
-                                        ThreadPool& threadPool, bool video)
-  : clip (clipToUse),
-    timeline (tl)
+TimeLine::ScopedBatch::ScopedBatch (TimeLine& ownerToUse, const String& transactionNameToUse)
+  : owner (ownerToUse),
+    transactionName (transactionNameToUse)
 {
-    if (video)
-    {
-        filmstrip = std::make_unique<foleys::FilmStrip>();
-        filmstrip->setClip (clip->clip);
-        addAndMakeVisible (filmstrip.get());
-    }
-    else
+    if (owner.batchDepth++ == 0 && transactionName.isNotEmpty())
+        owner.videoEngine.getUndoManager()->beginNewTransaction (transactionName);
+}
+
+TimeLine::ScopedBatch::~ScopedBatch()
+{
+    if (--owner.batchDepth > 0)
+        return;
+
+    if (transactionName.isNotEmpty())
+        owner.videoEngine.getUndoManager()->beginNewTransaction();
+
+    // a drag ends a batch on every mouse move, the update is coalesced with the next ones
+    if (! owner.changedClips.empty() || owner.clipsAddedOrRemoved)
+        owner.triggerAsyncUpdate();
+}
+
+//==============================================================================
+
+TimeLine::TimeMarker::TimeMarker (TimeLine& ownerToUse)
+  : owner (ownerToUse)
+{
+    setOpaque (true);
+    setInterceptsMouseClicks (false, false);
+    startTimerHz (60);
+}
+
+void TimeLine::TimeMarker::setTime (double seconds)
+{
+    time.store (seconds);
+}
+
+void TimeLine::TimeMarker::update()
+{
+    const auto x = owner.getXFromTime (time.load());
+    if (x != getX() || getHeight() != owner.getHeight())
+        setBounds (x, 0, 2, owner.getHeight());
+
+    // the view follows the playhead page by page
+    if (owner.player.isPlaying())
     {
-        audiostrip = std::make_unique<foleys::AudioStrip>();
-        audiostrip->setClip (clip->clip);
-        addAndMakeVisible (audiostrip.get());
+        if (auto* viewport = owner.findParentComponentOfClass<Viewport>())
+        {
+            const auto view = viewport->getViewArea();
+            if (x < view.getX() || x > view.getRight())
+                viewport->setViewPosition (jmax (0, x - view.getWidth() / 10), view.getY());
+        }
     }
+}
 
-    updateProcessorList();
+void TimeLine::TimeMarker::paint (Graphics& g)
+{
+    g.fillAll (Colours::red);
+}
+
+void TimeLine::TimeMarker::timerCallback()
+{
+    update();
+}
+
+//==============================================================================
+
+TimeLine::ImportPlaceholder::ImportPlaceholder (const String& nameToShow)
+  : name (nameToShow)
+{
+    setInterceptsMouseClicks (false, false);
+}
+
+void TimeLine::ImportPlaceholder::paint (Graphics& g)
+{
+    g.setColour (Colours::darkgrey.withAlpha (0.6f));
+    g.fillRoundedRectangle (getLocalBounds().toFloat(), 5.0f);
+    g.setColour (Colours::white);
+    g.drawFittedText (TRANS ("Importing") + " " + name + "...", getLocalBounds().reduced (5), Justification::topLeft, 2);
+}
+
+//==============================================================================
+
+TimeLine::ClipComponent::ClipComponent (TimeLine& tl,
+                                        std::shared_ptr<foleys::ClipDescriptor> clipToUse,
+                                        ThreadPool& threadPool, bool isVideo)
+  : timeline (tl),
+    video (isVideo)
+{
     processorSelect.setColour (ComboBox::backgroundColourId, Colours::black.withAlpha (0.2f));
     addAndMakeVisible (processorSelect);
     processorSelect.onChange = [&]
@@ -452,7 +1436,7 @@ TimeLine::ClipComponent::ClipComponent (TimeLine& tl,
         }
     };
 
-    clip->addListener (this);
+    setClip (clipToUse);
 }
 
 TimeLine::ClipComponent::~ClipComponent()
@@ -461,9 +1445,52 @@ TimeLine::ClipComponent::~ClipComponent()
         clip->removeListener (this);
 }
 
+void TimeLine::ClipComponent::setClip (std::shared_ptr<foleys::ClipDescriptor> clipToUse)
+{
+    if (clip.get() != nullptr)
+        clip->removeListener (this);
+
+    automations.clear();
+    processorSelect.clear (dontSendNotification);
+    dragmode = notDragging;
+    highlight = false;
+
+    clip = clipToUse;
+
+    // the strips are recycled with the component, the thumbnails and peaks come from the caches anyway
+    if (video)
+    {
+        if (filmstrip == nullptr)
+        {
+            filmstrip = std::make_unique<CachedFilmStrip>(timeline.thumbnailCache);
+            addAndMakeVisible (filmstrip.get());
+        }
+
+        filmstrip->setClip (clip != nullptr ? clip->clip : nullptr);
+    }
+    else
+    {
+        if (audiostrip == nullptr)
+        {
+            audiostrip = std::make_unique<CachedAudioStrip>(timeline.peakCache);
+            addAndMakeVisible (audiostrip.get());
+        }
+
+        audiostrip->setClip (clip != nullptr ? clip->clip : nullptr);
+    }
+
+    if (clip.get() == nullptr)
+        return;
+
+    processorSelect.toFront (false);
+    updateProcessorList();
+    clip->addListener (this);
+    resized();
+}
+
 void TimeLine::ClipComponent::paint (Graphics& g)
 {
-    bool selected = timeline.getSelectedClip() == clip;
+    bool selected = clip != nullptr && timeline.isSelected (clip.get());
 
     g.fillAll (Colours::darkgrey);
 
@@ -496,13 +1523,19 @@ void TimeLine::ClipComponent::resized()
         return;
 
     processorSelect.setBounds (190, 2, 160, 18);
+
+    // the thumbnails and waveforms of narrow clips wouldn't be readable anyway
+    const auto showStrips = getWidth() >= timeline.minStripWidth;
+
     if (filmstrip)
     {
+        filmstrip->setVisible (showStrips);
         filmstrip->setBounds (1, 20, getWidth() - 2, getHeight() - 25);
         filmstrip->setStartAndEnd (getLeftTime(), getRightTime());
     }
     if (audiostrip)
     {
+        audiostrip->setVisible (showStrips);
         audiostrip->setBounds (1, 20, getWidth() - 2, getHeight() - 25);
         audiostrip->setStartAndEnd (getLeftTime(), getRightTime());
     }
@@ -538,7 +1571,12 @@ void TimeLine::ClipComponent::mouseMove (const MouseEvent& event)
 void TimeLine::ClipComponent::mouseDown (const MouseEvent& event)
 {
     localDragStart = event.getPosition();
-    timeline.setSelectedClip (clip, isVideoClip());
+
+    // a click on a selected clip keeps the selection, so all selected clips can be dragged
+    if (event.mods.isShiftDown() || event.mods.isCommandDown())
+        timeline.toggleSelectedClip (clip, isVideoClip());
+    else if (! timeline.isSelected (clip.get()) || timeline.getSelectedClips().size() < 2)
+        timeline.setSelectedClip (clip, isVideoClip());
 
     if (event.x < 5)
         dragmode = dragOffset;
@@ -554,24 +1592,45 @@ void TimeLine::ClipComponent::mouseDrag (const MouseEvent& event)
     if (parent == nullptr)
         return;
 
+    // the selected clips follow by the same amount, updating the timeline once
+    auto clips = timeline.isSelected (clip.get()) ? timeline.getSelectedClips() : std::vector<std::shared_ptr<foleys::ClipDescriptor>> { clip };
+    TimeLine::ScopedBatch batch (timeline);
+
     if (dragmode == dragPosition)
-        clip->setStart (std::max (timeline.getTimeFromX ((event.x - localDragStart.x) + getX()), 0.0));
+    {
+        auto delta = std::max (timeline.getTimeFromX ((event.x - localDragStart.x) + getX()), 0.0) - clip->getStart();
+        for (auto& selected : clips)
+            delta = std::max (delta, -selected->getStart());
+
+        for (auto& selected : clips)
+            selected->setStart (selected->getStart() + delta);
+    }
     else if (dragmode == dragLength)
-        clip->setLength (std::min (timeline.getTimeFromX (event.x), clip->clip->getLengthInSeconds()));
+    {
+        const auto delta = std::min (timeline.getTimeFromX (event.x), clip->clip->getLengthInSeconds()) - clip->getLength();
+        for (auto& selected : clips)
+            selected->setLength (jlimit (0.0, selected->clip->getLengthInSeconds(), selected->getLength() + delta));
+    }
     else if (dragmode == dragOffset)
     {
-        auto oldPosition = clip->getStart();
-        auto oldOffset   = clip->getOffset();
-        auto oldLength   = clip->getLength();
-        auto delta = std::min (std::max (timeline.getTimeFromX ((event.x - localDragStart.x) + getX()) - oldPosition,
-                                         -oldOffset), oldLength);
-        clip->setStart (oldPosition + delta);
-        clip->setOffset (oldOffset + delta);
-        clip->setLength (oldLength - delta);
-        clip->updateSampleCounts();
+        const auto delta = timeline.getTimeFromX ((event.x - localDragStart.x) + getX()) - clip->getStart();
+        for (auto& selected : clips)
+        {
+            auto oldPosition = selected->getStart();
+            auto oldOffset   = selected->getOffset();
+            auto oldLength   = selected->getLength();
+            auto clipDelta = std::min (std::max (delta, -oldOffset), oldLength);
+            selected->setStart (oldPosition + clipDelta);
+            selected->setOffset (oldOffset + clipDelta);
+            selected->setLength (oldLength - clipDelta);
+            selected->updateSampleCounts();
+        }
     }
 
-    if (filmstrip)
+    if (clips.size() > 1)
+        return;
+
+    if (isVideoClip())
     {
         int line = (event.y + getY() - timeline.margin) / (timeline.videoHeight + timeline.margin);
         if (line != timeline.getVideoLine (clip))
@@ -584,13 +1643,17 @@ void TimeLine::ClipComponent::mouseDrag (const MouseEvent& event)
             timeline.setAudioLine (clip, line);
     }
 
-    parent->resized();
+    timeline.layoutClip (*this);
 }
 
 void TimeLine::ClipComponent::mouseUp (const MouseEvent& event)
 {
     dragmode = notDragging;
 
+    if (event.mouseWasDraggedSinceMouseDown() == false && ! event.mods.isShiftDown() && ! event.mods.isCommandDown()
+        && timeline.getSelectedClips().size() > 1)
+        timeline.setSelectedClip (clip, isVideoClip());
+
     if (event.mouseWasDraggedSinceMouseDown() == false)
         timeline.player.setPosition (timeline.getTimeFromX (timeline.getLocalPoint (this, event.getPosition()).getX()));
 }
@@ -692,7 +1755,7 @@ void TimeLine::ClipComponent::updateParameterGraphs (foleys::ControllableBase& c
 
 bool TimeLine::ClipComponent::isVideoClip() const
 {
-    return filmstrip.get() != nullptr;
+    return video;
 }
 
 void TimeLine::ClipComponent::processorControllerAdded()
@@ -707,6 +1770,9 @@ void TimeLine::ClipComponent::processorControllerToBeDeleted (const foleys::Proc
 
 void TimeLine::ClipComponent::parameterAutomationChanged (const foleys::ParameterAutomation*)
 {
+    for (auto& graph : automations)
+        graph->updateCurve();
+
     repaint();
 }
 
@@ -726,24 +1792,36 @@ void TimeLine::ClipComponent::ParameterGraph::setColour (juce::Colour colourToUs
     repaint();
 }
 
+void TimeLine::ClipComponent::ParameterGraph::updateCurve()
+{
+    curve.update();
+    repaint();
+}
+
 void TimeLine::ClipComponent::ParameterGraph::paint (Graphics& g)
 {
     g.setColour (colour);
-    auto lastX = 1;
-    auto lastY = mapFromValue (automation.getValueForTime (owner.getLeftTime()));
 
-    for (const auto& it : automation.getKeyframes())
+    // only the keyframes in the area to repaint are visited
+    const auto area = g.getClipBounds();
+    auto lastX = jmax (1, area.getX() - 4);
+    auto lastY = mapFromValue (curve.getValueForTime (mapToTime (lastX)));
+    const auto endX = jmin (getWidth() - 2, area.getRight() + 4);
+
+    for (auto i = curve.getFirstKeyframeAt (mapToTime (lastX)); i < curve.getNumKeyframes(); ++i)
     {
-        auto nextX = mapFromTime (it.first);
-        auto nextY = mapFromValue (it.second);
+        auto nextX = mapFromTime (curve.getKeyframeTime (i));
+        if (nextX > endX)
+            break;
+
+        auto nextY = mapFromValue (curve.getKeyframeValue (i));
         g.drawLine (lastX, lastY, nextX, nextY, 2.0f);
         g.fillEllipse (nextX - 3, nextY - 3, 7, 7);
         lastX = nextX;
         lastY = nextY;
     }
 
-    const auto end = owner.getRightTime();
-    g.drawLine (lastX, lastY, mapFromTime (end), mapFromValue (automation.getValueForTime (end)), 2.0f);
+    g.drawLine (lastX, lastY, endX, mapFromValue (curve.getValueForTime (mapToTime (endX))), 2.0f);
 }
 
 void TimeLine::ClipComponent::ParameterGraph::mouseDown (const MouseEvent& event)
@@ -753,7 +1831,7 @@ void TimeLine::ClipComponent::ParameterGraph::mouseDown (const MouseEvent& event
     if (draggingIndex >= 0 && event.mods.isCtrlDown())
     {
         automation.deleteKeyframe (draggingIndex);
-        repaint();
+        updateCurve();
         return;
     }
 
@@ -766,6 +1844,7 @@ void TimeLine::ClipComponent::ParameterGraph::mouseDown (const MouseEvent& event
         else
         {
             automation.addKeyframe (mapToTime (event.x), mapToValue (event.y));
+            curve.update();
             draggingIndex = findClosestKeyFrame (event.x, event.y);
         }
     }
@@ -777,12 +1856,13 @@ void TimeLine::ClipComponent::ParameterGraph::mouseDrag (const MouseEvent& event
     {
         automation.setValue (mapToValue (event.y));
     }
-    else if (isPositiveAndBelow (draggingIndex, automation.getKeyframes().size()))
+    else if (isPositiveAndBelow (draggingIndex, curve.getNumKeyframes()))
     {
         const auto time = mapToTime (event.x);
         const auto value = mapToValue (event.y);
 
         automation.setKeyframe (draggingIndex, time, value);
+        curve.update();
         draggingIndex = findClosestKeyFrame (event.x, jlimit (1, getHeight() - 2, event.y));
     }
 
@@ -803,18 +1883,19 @@ bool TimeLine::ClipComponent::ParameterGraph::hitTest (int x, int y)
     if (key >= 0)
         return true;
 
-    return std::abs (mapFromValue (automation.getValueForTime (mapToTime (x))) - y) < 3.0;
+    return std::abs (mapFromValue (curve.getValueForTime (mapToTime (x))) - y) < 3.0;
 }
 
 int TimeLine::ClipComponent::ParameterGraph::findClosestKeyFrame (int x, int y) const
 {
-    int index = 0;
-    for (const auto& it : automation.getKeyframes())
+    for (auto i = curve.getFirstKeyframeAt (mapToTime (x - 4)); i < curve.getNumKeyframes(); ++i)
     {
-        if (std::abs (mapFromTime (it.first) - x) < 4 && std::abs (mapFromValue (it.second) - y) < 5)
-            return index;
+        const auto keyX = mapFromTime (curve.getKeyframeTime (i));
+        if (keyX - x >= 4)
+            break;
 
-        ++index;
+        if (std::abs (keyX - x) < 4 && std::abs (mapFromValue (curve.getKeyframeValue (i)) - y) < 5)
+            return i;
     }
 
     return -1;
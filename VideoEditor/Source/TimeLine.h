@@ -27,6 +27,10 @@
 #pragma once
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "AutomationCurve.h"
+#include "CachedAudioStrip.h"
+#include "CachedFilmStrip.h"
+#include "ProxyManager.h"
 
 //==============================================================================
 /*
@@ -36,10 +40,12 @@ class TimeLine    : public Component,
                     public FileDragAndDropTarget,
                     public TextDragAndDropTarget,
                     public foleys::AVClip::TimecodeListener,
-                    public ValueTree::Listener
+                    public ValueTree::Listener,
+                    private AsyncUpdater
 {
 public:
-    TimeLine (foleys::VideoEngine& videoEngine, Player& player, Properties& properies);
+    TimeLine (foleys::VideoEngine& videoEngine, Player& player, Properties& properies,
+              ThumbnailCache& thumbnailCache, PeakCache& peakCache, ProxyManager& proxyManager);
     ~TimeLine();
 
     bool isInterestedInFileDrag (const StringArray& files) override;
@@ -50,16 +56,42 @@ public:
     void textDropped (const String& text, int x, int y) override;
 
     void mouseDown (const MouseEvent& event) override;
+    void mouseWheelMove (const MouseEvent& event, const MouseWheelDetails& wheel) override;
 
     void paint (Graphics&) override;
+    void paintOverChildren (Graphics&) override;
     void resized() override;
+    void moved() override;
     void timecodeChanged (int64_t count, double seconds) override;
 
+    /** Sets the zoom in pixels per second, the time anchorTime stays at the same place in the viewport */
+    void setZoom (double pixelsPerSecondToUse, double anchorTime);
+    double getPixelsPerSecond() const;
+
+    /** Shows the whole edit in the viewport */
+    void zoomToFit();
+
+    /** Adapts the width to the length of the edit and the zoom, call this when the viewport was resized */
+    void updateSize();
+
+    /** Sets the edit to show. It is shown once the player has prepared it, so it can't be
+        changed while it is prepared on the pool. */
     void setEditClip (std::shared_ptr<foleys::ComposedClip> clip);
+
+    /** Returns the edit set last, even if it is not shown yet */
     std::shared_ptr<foleys::ComposedClip> getEditClip() const;
 
+    /** Selects only this clip and shows its properties */
     void setSelectedClip (std::shared_ptr<foleys::ClipDescriptor> clip, bool video);
+
+    /** Adds the clip to the selection or removes it, if it was selected */
+    void toggleSelectedClip (std::shared_ptr<foleys::ClipDescriptor> clip, bool video);
+    void selectAllClips();
+
+    /** Returns the clip selected last, which shows its properties */
     std::shared_ptr<foleys::ClipDescriptor> getSelectedClip() const;
+    std::vector<std::shared_ptr<foleys::ClipDescriptor>> getSelectedClips() const;
+    bool isSelected (const foleys::ClipDescriptor* clip) const;
     bool selectedClipIsVideo() const;
 
     void toggleVisibility();
@@ -67,8 +99,24 @@ public:
     void spliceSelectedClipAtPlayPosition();
     void spliceSelectedClipAtPosition (double pts);
 
+    /** Splits all clips in all lanes at the play position */
+    void spliceAllClipsAtPlayPosition();
+
+    void deleteSelectedClips();
+
+    /** Deletes the selected clips and moves the clips after them to close the gaps */
+    void rippleDeleteSelectedClips();
+
     void restoreClipComponents();
 
+    /** Applies the clips added, removed or changed in the edit now, instead of on the message thread later */
+    void updateClipsNow();
+
+    /** Sets the start or the end of the loop range of the player, the other end is kept if it still fits */
+    void setLoopIn (double seconds);
+    void setLoopOut (double seconds);
+    void toggleLooping();
+
     class ClipComponent   : public Component,
                             public DragAndDropTarget,
                             private foleys::ClipDescriptor::Listener
@@ -77,6 +125,9 @@ public:
         ClipComponent (TimeLine& tl, std::shared_ptr<foleys::ClipDescriptor> clip, ThreadPool& threadPool, bool video);
         ~ClipComponent();
 
+        /** Shows a different clip, used when the component is recycled. nullptr releases the clip. */
+        void setClip (std::shared_ptr<foleys::ClipDescriptor> clip);
+
         void paint (Graphics& g) override;
         void resized() override;
 
@@ -104,6 +155,9 @@ public:
 
             void setColour (juce::Colour colour);
 
+            /** Call this when the automation was changed from outside */
+            void updateCurve();
+
             void paint (Graphics& g) override;
 
             bool hitTest (int x, int y) override;
@@ -123,6 +177,7 @@ public:
 
             ClipComponent& owner;
             foleys::ParameterAutomation& automation;
+            AutomationCurve curve { automation };
             int draggingIndex = -1;
 
             juce::Colour colour { juce::Colours::silver };
@@ -147,8 +202,9 @@ public:
         };
 
         TimeLine& timeline;
-        std::unique_ptr<foleys::FilmStrip>  filmstrip;
-        std::unique_ptr<foleys::AudioStrip> audiostrip;
+        const bool video;
+        std::unique_ptr<CachedFilmStrip>    filmstrip;
+        std::unique_ptr<CachedAudioStrip>   audiostrip;
         ComboBox processorSelect;
 
         DragMode dragmode = notDragging;
@@ -171,16 +227,31 @@ public:
 
     double getSampleRate() const;
 
-    class TimeMarker : public Component
+    /*
+        The playhead on top of the clips. The timecode only stores the time, the
+        marker moves at the display rate and only if it changed the pixel. Being
+        opaque the clips below the new position don't need to be painted.
+    */
+    class TimeMarker : public Component,
+                       private Timer
     {
     public:
-        TimeMarker() = default;
-        void paint (Graphics& g)
-        {
-            g.setColour (Colours::red);
-            g.drawVerticalLine (1, 0, getHeight());
-        }
+        TimeMarker (TimeLine& owner);
+
+        /** Can be called from any thread */
+        void setTime (double seconds);
+
+        /** Moves the marker to the time now */
+        void update();
+
+        void paint (Graphics& g) override;
+
     private:
+        void timerCallback() override;
+
+        TimeLine& owner;
+        std::atomic<double> time { 0.0 };
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimeMarker)
     };
 
@@ -201,13 +272,179 @@ public:
 
 private:
 
-    void addClipToEdit (std::shared_ptr<foleys::AVClip> clip, double start, int y);
-    void addClipComponent (std::shared_ptr<foleys::ClipDescriptor> clip, bool video);
+    /*
+        One entry for each clip and stream type in the edit. Only the entries in
+        the visible time range have a ClipComponent.
+    */
+    struct ClipEntry
+    {
+        std::shared_ptr<foleys::ClipDescriptor> clip;
+        bool video = true;
+        ClipComponent* component = nullptr;
+        int visibleGeneration = -1;
+        int restoreGeneration = -1;
+
+        // where the entry is in the lane index, -1 if it isn't
+        int    lane = -1;
+        double indexedStart = 0.0;
+    };
+
+    struct ClipKey
+    {
+        const foleys::ClipDescriptor* clip = nullptr;
+        bool video = true;
+
+        bool operator== (const ClipKey& other) const { return clip == other.clip && video == other.video; }
+    };
+
+    struct ClipKeyHash
+    {
+        size_t operator() (const ClipKey& key) const noexcept
+        {
+            return std::hash<const void*>() (key.clip) ^ size_t (key.video);
+        }
+    };
+
+    /*
+        The clips of one lane sorted by start time, with the running maximum of
+        the end times. That allows to find all clips overlapping a time range
+        with a binary search, without visiting the clips before it.
+    */
+    class LaneIndex
+    {
+    public:
+        LaneIndex() = default;
+
+        void clear();
+        void add (ClipEntry* entry, double start, double end);
+
+        /** Sorts the entries, call this after adding all clips */
+        void build();
+
+        /** Inserts or removes one entry of a built index, without sorting the others again */
+        void insert (ClipEntry* entry, double start, double end);
+        void remove (ClipEntry* entry, double start);
+
+        /** Returns the time ranges covered by clips, gaps shorter than minGap are closed */
+        std::vector<Range<double>> getSpans (double minGap) const;
+
+        template<typename Callback>
+        void forEachInRange (Range<double> range, Callback&& callback) const
+        {
+            auto it = std::upper_bound (entries.begin(), entries.end(), range.getEnd(),
+                                        [](double time, const Entry& entry) { return time < entry.start; });
+
+            for (auto index = std::distance (entries.begin(), it) - 1; index >= 0 && maxEnd [size_t (index)] > range.getStart(); --index)
+                if (entries [size_t (index)].end > range.getStart())
+                    callback (*entries [size_t (index)].clip);
+        }
+
+    private:
+        struct Entry
+        {
+            double start = 0.0;
+            double end   = 0.0;
+            ClipEntry* clip = nullptr;
+        };
+
+        void updateMaxEnd (size_t from);
+
+        std::vector<Entry>  entries;
+        std::vector<double> maxEnd;
+    };
+
+    void handleAsyncUpdate() override;
+
+    /*
+        Groups the changes to several clips. With a name they become one undo
+        transaction. The timeline collects the clips that were changed and only
+        lays out those, once, after the outermost batch has ended.
+    */
+    class ScopedBatch
+    {
+    public:
+        ScopedBatch (TimeLine& owner, const String& transactionName = {});
+        ~ScopedBatch();
+    private:
+        TimeLine& owner;
+        const String transactionName;
+        JUCE_DECLARE_NON_COPYABLE (ScopedBatch)
+    };
+
+    bool spliceClipAtPosition (std::shared_ptr<foleys::ClipDescriptor> clip, double pts);
+    void repaintClips();
+
+    /*
+        Shown at the drop position while the media is opened on the import pool
+    */
+    class ImportPlaceholder : public Component
+    {
+    public:
+        ImportPlaceholder (const String& name);
+        void paint (Graphics& g) override;
+    private:
+        const String name;
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImportPlaceholder)
+    };
+
+    struct PendingImport
+    {
+        URL    url;
+        int    id = 0;
+        int    group = 0;
+        double start = 0.0;
+        int    y = 0;
+        bool   finished = false;
+        std::shared_ptr<foleys::AVClip> clip;
+        std::unique_ptr<ImportPlaceholder> placeholder;
+    };
+
+    /** Opens the media on the import pool and adds the clips one after another, in the order of urls */
+    void importMedia (const Array<URL>& urls, double start, int y);
+    void importFinished (int importId, std::shared_ptr<foleys::AVClip> clip);
+    Rectangle<int> getPlaceholderBounds (const PendingImport& import) const;
+
+    /** Creates the clip from the proxy if there is one, otherwise from the original. Called on the import pool. */
+    static std::shared_ptr<foleys::AVClip> createClip (foleys::VideoEngine& engine, ThumbnailCache& cache,
+                                                       const URL& url, const URL& proxy, int thumbnailHeight);
+    std::shared_ptr<foleys::ClipDescriptor> addClipToEdit (std::shared_ptr<foleys::AVClip> clip, double start, int y);
+
+    Rectangle<int> getClipBounds (const ClipComponent& component) const;
+    void layoutClip (ClipComponent& component);
+    Range<double> getVisibleTimeRange() const;
+    void rebuildLaneIndex();
+
+    /** Adds the entries for the streams of the clip, if they don't exist yet */
+    void addClipEntries (std::shared_ptr<foleys::ClipDescriptor> descriptor);
+    ClipEntry& addClipEntry (std::shared_ptr<foleys::ClipDescriptor> descriptor, bool video);
+    void removeClipEntries (const ValueTree& state);
+
+    /** Returns the clip of a state in the edit, or nullptr if the edit doesn't have one */
+    std::shared_ptr<foleys::ClipDescriptor> findClip (const ValueTree& state) const;
+
+    /** Moves the entry to its current place in the lane index, if the index is built */
+    void indexClip (ClipEntry& entry);
+    void unindexClip (ClipEntry& entry);
+    LaneIndex& getLane (const ClipEntry& entry);
+
+    /** The shared properties identify the state of a clip, also after it was removed from the edit */
+    static const void* getStateKey (const ValueTree& state);
+
+    /** Shows the edit and listens to it, called when the player is ready to play it */
+    void attachEdit (std::shared_ptr<foleys::ComposedClip> clip);
+
+    /** Creates the components for the clips in the visible range and recycles the others */
+    void updateVisibleComponents();
+    ClipComponent* acquireComponent (ClipEntry& entry);
+    void releaseComponent (ClipEntry& entry);
 
     foleys::VideoEngine& videoEngine;
     Player&     player;
     Properties& properties;
-    TimeMarker  timemarker;
+    ThumbnailCache& thumbnailCache;
+    PeakCache&  peakCache;
+    ProxyManager& proxyManager;
+    TimeMarker  timemarker { *this };
 
     const int numVideoLines = 2;
     const int numAudioLines = 3;
@@ -218,11 +455,68 @@ private:
     double timelineLength = 60.0;
 
     std::shared_ptr<foleys::ComposedClip> edit;
+    std::shared_ptr<foleys::ComposedClip> pendingEdit;
+
+    std::unordered_map<ClipKey, std::unique_ptr<ClipEntry>, ClipKeyHash> clipEntries;
+    int restoreGeneration = 0;
+
+    // finds the clip to a changed or removed state tree
+    std::unordered_map<const void*, const foleys::ClipDescriptor*> clipsByState;
 
+    // all components are owned here, the ones not in use are invisible and in the pools
     std::vector<std::unique_ptr<ClipComponent>> clipComponents;
+    std::vector<ClipComponent*> videoPool;
+    std::vector<ClipComponent*> audioPool;
+    std::vector<ClipEntry*>     visibleEntries;
+    int visibleGeneration = 0;
+
+    std::vector<LaneIndex> videoLanes { size_t (numVideoLines) };
+    std::vector<LaneIndex> audioLanes { size_t (numAudioLines) };
+    bool laneIndexValid = false;
+
+    /*
+        The lanes merged to spans at the current zoom. They are painted below the
+        ClipComponents, and instead of them when zoomed out.
+    */
+    void rebuildSpans();
+    bool isOverview() const;
+
+    std::vector<std::vector<Range<double>>> videoSpans;
+    std::vector<std::vector<Range<double>>> audioSpans;
+    double spansPixelsPerSecond = 0.0;
+
+    const double overviewPixelsPerSecond = 1.0;
+    const double maxPixelsPerSecond = 200.0;
+    const int    minClipWidth = 6;
+    const int    minStripWidth = 48;
+    const int    maxBufferedWidth = 2048;
+
+    // the states are kept, so their keys can't be reused until they are handled
+    std::unordered_map<const void*, ValueTree> changedClips;
+    std::unordered_map<const void*, ValueTree> addedClips;
+    bool clipsAddedOrRemoved = false;
+
+    // more changes are cheaper to sort at once, like after a ripple delete
+    const size_t maxIncrementalChanges = 32;
+
+    int batchDepth = 0;
+
+    double pixelsPerSecond = 0.0;
+
+    // 0 fits the edit into the viewport
+    double zoom = 0.0;
+
+    std::vector<std::unique_ptr<PendingImport>> imports;
+    std::map<int, double> importGroupEnds;
+    int nextImportId = 0;
+    int nextImportGroup = 0;
+    const double placeholderLength = 5.0;
 
     std::weak_ptr<foleys::ClipDescriptor> selectedClip;
+    std::vector<std::weak_ptr<foleys::ClipDescriptor>> selection;
     bool selectedIsVideo = false;
 
+    ThreadPool importPool { 4 };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimeLine)
 };
@@ -64,8 +64,8 @@ void TransportControl::paint (Graphics& g)
     g.fillAll (getLookAndFeel().findColour (ResizableWindow::backgroundColourId));
     g.setColour (Colours::silver);
 
-    auto bounds = getLocalBounds().reduced (1);
-    g.drawFittedText (foleys::timecodeToString (player.getCurrentTimeInSeconds()), bounds, Justification::right, 1);
+    timecode = foleys::timecodeToString (player.getCurrentTimeInSeconds());
+    g.drawFittedText (timecode, getTimecodeBounds(), Justification::right, 1);
 }
 
 void TransportControl::resized()
@@ -77,7 +77,14 @@ void TransportControl::resized()
 
 void TransportControl::timerCallback()
 {
-    repaint();
+    // only the text is painted again, and only if it changed
+    if (foleys::timecodeToString (player.getCurrentTimeInSeconds()) != timecode)
+        repaint (getTimecodeBounds());
+}
+
+Rectangle<int> TransportControl::getTimecodeBounds() const
+{
+    return getLocalBounds().reduced (1).withTrimmedLeft (160);
 }
 
 void TransportControl::changeListenerCallback (ChangeBroadcaster*)
@@ -47,7 +47,10 @@ public:
     void changeListenerCallback (ChangeBroadcaster* sender) override;
 
 private:
+    Rectangle<int> getTimecodeBounds() const;
+
     Player& player;
+    String  timecode;
 
     TextButton zero { NEEDS_TRANS ("Return") };
     TextButton stop { NEEDS_TRANS ("Stop") };